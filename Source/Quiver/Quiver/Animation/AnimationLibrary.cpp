@@ -1,5 +1,7 @@
 #include "AnimationLibrary.h"
 
+#include <algorithm>
+
 #include <spdlog/spdlog.h>
 #include <spdlog/fmt/ostr.h>
 
@@ -28,28 +30,81 @@ AnimationId AnimationLibrary::Add(const AnimationData& anim)
 		return id;
 	}
 
+	unsigned rectBlock = 0;
+	const Animation::Rect* const firstRect = StoreRects(anim.GetRects(), rectBlock);
+
 	infos[id] =
 		AnimationInfo(
-			allFrameRects.size(),
+			firstRect,
+			rectBlock,
 			allFrameTimes.size(),
 			anim.GetRectCount(),
 			anim.GetRectCount() / anim.GetFrameCount());
 
-	// Pack the animation's frame views and times into the arrays.
+	// Pack the animation's frame times into the array.
 	const auto frameTimes = anim.GetTimes();
 	allFrameTimes.insert(
 		allFrameTimes.end(),
 		frameTimes.begin(),
 		frameTimes.end());
-	const auto frameRects = anim.GetRects();
-	allFrameRects.insert(
-		allFrameRects.end(),
-		frameRects.begin(),
-		frameRects.end());
+
+	// And when each frame starts.
+	{
+		AnimationInfo& info = infos[id];
+
+		info.mIndexOfFirstStartTime = allFrameStartTimes.size();
+		info.mShortestFrameTime = *std::min_element(frameTimes.begin(), frameTimes.end());
+
+		Animation::TimeUnit::rep startTime = 0;
+
+		for (const Animation::TimeUnit frameTime : frameTimes) {
+			allFrameStartTimes.push_back(startTime);
+			startTime += frameTime.count();
+		}
+
+		allFrameStartTimes.push_back(startTime);
+	}
 
 	return id;
 }
 
+auto AnimationLibrary::StoreRects(
+	const gsl::span<const Animation::Rect> rects,
+	unsigned& blockIndex)
+		-> const Animation::Rect*
+{
+	const unsigned MinBlockCapacity = 1024;
+
+	const unsigned count = rects.size();
+
+	blockIndex = 0;
+
+	while (blockIndex < allFrameRects.size() &&
+		allFrameRects[blockIndex].mSize + count > allFrameRects[blockIndex].mCapacity)
+	{
+		blockIndex++;
+	}
+
+	if (blockIndex == allFrameRects.size())
+	{
+		RectBlock block;
+		block.mCapacity = std::max(count, MinBlockCapacity);
+		block.mRects = std::make_unique<Animation::Rect[]>(block.mCapacity);
+
+		allFrameRects.push_back(std::move(block));
+	}
+
+	RectBlock& block = allFrameRects[blockIndex];
+
+	Animation::Rect* const first = block.mRects.get() + block.mSize;
+
+	std::copy(rects.begin(), rects.end(), first);
+
+	block.mSize += count;
+
+	return first;
+}
+
 AnimationId AnimationLibrary::Add(const AnimationData& anim, const AnimationSourceInfo& sourceInfo)
 {
 	const AnimationId newAnim = Add(anim);
@@ -80,13 +135,6 @@ bool AnimationLibrary::Remove(const AnimationId anim)
 
 	infos.erase(anim);
 
-	// Erase views.
-	{
-		auto start = allFrameRects.begin() + targetAnimInfo.mIndexOfFirstRect;
-		auto end = start + targetAnimInfo.mNumRects;
-		allFrameRects.erase(start, end);
-	}
-
 	// Erase times.
 	{
 		auto start = allFrameTimes.begin() + targetAnimInfo.mIndexOfFirstTime;
@@ -94,27 +142,49 @@ bool AnimationLibrary::Remove(const AnimationId anim)
 		allFrameTimes.erase(start, end);
 	}
 
-	// Loop through the remaining AnimationInfos and fix up the indexOfFirstRect members
-	// of those whose indexOfFirstRect was greater than this one's
+	// Erase start times.
+	{
+		auto start = allFrameStartTimes.begin() + targetAnimInfo.mIndexOfFirstStartTime;
+		auto end = start + targetAnimInfo.NumFrames() + 1;
+		allFrameStartTimes.erase(start, end);
+	}
+
+	// Loop through the remaining AnimationInfos and fix up the indexOfFirstTime members
+	// of those whose indexOfFirstTime was greater than this one's
 	for (auto& kvp : infos) {
-		if (kvp.second.mIndexOfFirstRect > targetAnimInfo.mIndexOfFirstRect) {
+		if (kvp.second.mIndexOfFirstTime > targetAnimInfo.mIndexOfFirstTime) {
 			AnimationInfo newAnimInfo(kvp.second);
 
-			newAnimInfo.mIndexOfFirstRect -= targetAnimInfo.mNumRects;
+			newAnimInfo.mIndexOfFirstTime -= targetAnimInfo.NumFrames();
 
 			infos[kvp.first] = newAnimInfo;
 		}
 	}
 
-	// And repeat for times.
+	// And repeat for start times.
 	for (auto& kvp : infos) {
-		if (kvp.second.mIndexOfFirstTime > targetAnimInfo.mIndexOfFirstTime) {
-			AnimationInfo newAnimInfo(kvp.second);
+		if (kvp.second.mIndexOfFirstStartTime > targetAnimInfo.mIndexOfFirstStartTime) {
+			kvp.second.mIndexOfFirstStartTime -= targetAnimInfo.NumFrames() + 1;
+		}
+	}
 
-			newAnimInfo.mIndexOfFirstTime -= targetAnimInfo.NumFrames();
+	// Other animations' rects can't move, since ViewBuffers point at them, so only give
+	// back what's after the last one left in the block.
+	{
+		RectBlock& block = allFrameRects[targetAnimInfo.mRectBlock];
 
-			infos[kvp.first] = newAnimInfo;
+		unsigned newSize = 0;
+
+		for (const auto& kvp : infos) {
+			if (kvp.second.mRectBlock != targetAnimInfo.mRectBlock) continue;
+
+			const unsigned end = 
+				(unsigned)(kvp.second.mFirstRect - block.mRects.get()) + kvp.second.mNumRects;
+
+			newSize = std::max(newSize, end);
 		}
+
+		block.mSize = newSize;
 	}
 
 	log->debug("{} Successfully removed animation. Remaining: {}", logCtx, GetCount());
@@ -180,11 +250,11 @@ auto AnimationLibrary::GetRect(
 	const int viewIndex)
 		const -> Animation::Rect
 {
-	const AnimationInfo info = infos.at(anim);
+	const AnimationInfo& info = infos.at(anim);
 
 	const int rectIndex = (frameIndex * info.mNumRectsPerFrame) + viewIndex;
 
-	return allFrameRects[info.mIndexOfFirstRect + rectIndex];
+	return info.mFirstRect[rectIndex];
 }
 
 auto AnimationLibrary::GetRects(
@@ -192,12 +262,12 @@ auto AnimationLibrary::GetRects(
 	const int frameIndex)
 		const -> gsl::span<const Animation::Rect>
 {
-	const AnimationInfo info = infos.at(anim);
+	const AnimationInfo& info = infos.at(anim);
 
 	const int firstRectIndex = (frameIndex * (info.mNumRectsPerFrame));
 
 	return gsl::make_span(
-		&allFrameRects[info.mIndexOfFirstRect + firstRectIndex],
+		info.mFirstRect + firstRectIndex,
 		info.mNumRectsPerFrame);
 }
 
@@ -206,11 +276,26 @@ auto AnimationLibrary::GetTime(
 	const int frameIndex)
 		const -> Animation::TimeUnit
 {
-	const AnimationInfo info = infos.at(anim);
+	const AnimationInfo& info = infos.at(anim);
 
 	return allFrameTimes[info.mIndexOfFirstTime + frameIndex];
 }
 
+auto AnimationLibrary::GetFrameStartTimes(const AnimationId anim) 
+	const -> gsl::span<const Animation::TimeUnit::rep>
+{
+	const AnimationInfo& info = infos.at(anim);
+
+	return gsl::make_span(
+		&allFrameStartTimes[info.mIndexOfFirstStartTime],
+		info.NumFrames() + 1);
+}
+
+auto AnimationLibrary::GetShortestFrameTime(const AnimationId anim) const -> Animation::TimeUnit
+{
+	return infos.at(anim).mShortestFrameTime;
+}
+
 template<typename KeyType, typename ValType>
 auto ExtractKeys(const std::unordered_map<KeyType, ValType> map) -> std::vector<KeyType>
 {
@@ -233,6 +318,16 @@ auto AnimationLibrary::GetIds() const -> std::vector<AnimationId> {
 	return ExtractKeys(infos);
 }
 
+auto AnimationLibrary::GetRectCapacity() const -> int {
+	int capacity = 0;
+
+	for (const RectBlock& block : allFrameRects) {
+		capacity += block.mCapacity;
+	}
+
+	return capacity;
+}
+
 using json = nlohmann::json;
 
 void to_json(json& j, const AnimationSourceInfo& animationSource) {
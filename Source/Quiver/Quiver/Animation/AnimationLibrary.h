@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
@@ -55,6 +56,7 @@ public:
 		const int viewIndex = 0) 
 			const -> Animation::Rect;
 
+	// Stays valid until the animation is removed.
 	auto GetRects(
 		const AnimationId anim,
 		const int frameIndex)
@@ -65,18 +67,29 @@ public:
 		const int frameIndex) 
 			const -> Animation::TimeUnit;
 
+	// When each frame starts, from the start of the animation, and then when the last one ends.
+	auto GetFrameStartTimes(const AnimationId anim) 
+		const -> gsl::span<const Animation::TimeUnit::rep>;
+
+	auto GetShortestFrameTime(const AnimationId anim) const -> Animation::TimeUnit;
+
 	auto GetIds() const -> std::vector<AnimationId>;
 
+	// How many rects there's room for, used or not.
+	auto GetRectCapacity() const -> int;
+
 	friend void to_json(nlohmann::json& j, const AnimationLibrary& animations);
 
 private:
 	struct AnimationInfo {
 		AnimationInfo(
-			const unsigned indexOfFirstRect,
+			const Animation::Rect* firstRect,
+			const unsigned rectBlock,
 			const unsigned indexOfFirstTime,
 			const unsigned numRects,
 			const unsigned numRectsPerFrame)
-			: mIndexOfFirstRect(indexOfFirstRect)
+			: mFirstRect(firstRect)
+			, mRectBlock(rectBlock)
 			, mIndexOfFirstTime(indexOfFirstTime)
 			, mNumRects(numRects)
 			, mNumRectsPerFrame(numRectsPerFrame)
@@ -90,10 +103,14 @@ private:
 
 		std::experimental::optional<AnimationSourceInfo> mSourceInfo;
 	
-		unsigned mIndexOfFirstRect = 0;
+		const Animation::Rect* mFirstRect = nullptr;
+		unsigned mRectBlock = 0;
 		unsigned mIndexOfFirstTime = 0;
 		unsigned mNumRects = 0;
 		unsigned mNumRectsPerFrame = 0;
+
+		unsigned mIndexOfFirstStartTime = 0;
+		Animation::TimeUnit mShortestFrameTime = Animation::TimeUnit::zero();
 	};
 
 	std::unordered_map<AnimationId, AnimationInfo> infos;
@@ -101,8 +118,27 @@ private:
 	// Time values for each frame in every animation.
 	std::vector<Animation::TimeUnit> allFrameTimes;
 
+	// Each animation's frame start times, with its total time on the end.
+	std::vector<Animation::TimeUnit::rep> allFrameStartTimes;
+
+	struct RectBlock {
+		std::unique_ptr<Animation::Rect[]> mRects;
+		unsigned mSize = 0;
+		unsigned mCapacity = 0;
+	};
+
+	// Copies the rects onto the end of the first block they fit in, or a new one.
+	auto StoreRects(
+		const gsl::span<const Animation::Rect> rects,
+		unsigned& blockIndex)
+			-> const Animation::Rect*;
+
 	// Rects for each frame in every animation, including alt view rects.
-	std::vector<Animation::Rect> allFrameRects; 
+	// They're kept in blocks that never move, with each animation's rects in one
+	// block, so that ViewBuffers can point at them rather than copying them.
+	// A block's size shrinks back to the end of its last animation when others
+	// are removed, and the space is reused.
+	std::vector<RectBlock> allFrameRects;
 };
 
 void to_json(nlohmann::json& j, const AnimationLibrary& animations);
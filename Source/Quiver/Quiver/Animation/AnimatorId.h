@@ -3,19 +3,22 @@
 #include <functional>
 #include <ostream>
 
+#include "Quiver/Misc/SlotMap.h"
+
 namespace qvr {
 
+// The key to an Animator's slot in its AnimatorCollection.
 class AnimatorId
 {
 public:
-	explicit AnimatorId(const unsigned value) : mValue(value) {}
+	explicit AnimatorId(const SlotMapKey value) : mValue(value) {}
 
 	static const AnimatorId Invalid;
 
-	unsigned GetValue() const { return mValue; }
+	SlotMapKey GetValue() const { return mValue; }
 
 private:
-	unsigned mValue;
+	SlotMapKey mValue;
 };
 
 inline bool operator==(const AnimatorId lhs, const AnimatorId rhs) { return lhs.GetValue() == rhs.GetValue(); }
@@ -32,7 +35,7 @@ struct hash<qvr::AnimatorId>
 {
 	std::size_t operator()(const qvr::AnimatorId id) const
 	{
-		return hash<unsigned>{}(id.GetValue());
+		return hash<qvr::SlotMapKey>{}(id.GetValue());
 	}
 };
 }
\ No newline at end of file
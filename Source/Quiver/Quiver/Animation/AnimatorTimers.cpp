@@ -0,0 +1,152 @@
+#include "AnimatorTimers.h"
+
+#include <cassert>
+
+#if defined(__AVX2__)
+#define QUIVER_ANIMATOR_TIMERS_AVX2 1
+#include <immintrin.h>
+#else
+#define QUIVER_ANIMATOR_TIMERS_AVX2 0
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define QUIVER_ANIMATOR_TIMERS_SSE2 1
+#include <emmintrin.h>
+#else
+#define QUIVER_ANIMATOR_TIMERS_SSE2 0
+#endif
+
+namespace qvr {
+
+namespace Animation
+{
+
+namespace {
+
+using Tick = TimeUnit::rep;
+
+int AdvanceScalar(
+	Tick* const timers,
+	const int begin,
+	const int end,
+	const Tick time,
+	int* const expired,
+	int expiredCount)
+{
+	for (int i = begin; i < end; i++) {
+		timers[i] -= time;
+
+		// Always written, only kept if it ran out.
+		expired[expiredCount] = i;
+		expiredCount += (timers[i] <= 0);
+	}
+
+	return expiredCount;
+}
+
+// ranOut has a bit set for each of the laneCount timers from base on that ran out.
+inline int AppendExpired(
+	const unsigned ranOut,
+	const int laneCount,
+	const int base,
+	int* const expired,
+	int expiredCount)
+{
+	for (int lane = 0; lane < laneCount; lane++) {
+		expired[expiredCount] = base + lane;
+		expiredCount += (ranOut >> lane) & 1;
+	}
+
+	return expiredCount;
+}
+
+#if QUIVER_ANIMATOR_TIMERS_AVX2
+
+int AdvanceAvx2(Tick* const timers, const int count, const Tick time, int* const expired)
+{
+	const __m256i decrement = _mm256_set1_epi32(time);
+	const __m256i zero = _mm256_setzero_si256();
+
+	int expiredCount = 0;
+	int i = 0;
+
+	for (; i + 8 <= count; i += 8) {
+		__m256i* const p = reinterpret_cast<__m256i*>(timers + i);
+
+		const __m256i t = _mm256_sub_epi32(_mm256_loadu_si256(p), decrement);
+		_mm256_storeu_si256(p, t);
+
+		const unsigned stillRunning =
+			(unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(t, zero)));
+
+		// Usually nothing has run out.
+		if (stillRunning != 0xFF) {
+			expiredCount = AppendExpired(~stillRunning, 8, i, expired, expiredCount);
+		}
+	}
+
+	return AdvanceScalar(timers, i, count, time, expired, expiredCount);
+}
+
+#endif
+
+#if QUIVER_ANIMATOR_TIMERS_SSE2 && !QUIVER_ANIMATOR_TIMERS_AVX2
+
+int AdvanceSse2(Tick* const timers, const int count, const Tick time, int* const expired)
+{
+	const __m128i decrement = _mm_set1_epi32(time);
+	const __m128i zero = _mm_setzero_si128();
+
+	int expiredCount = 0;
+	int i = 0;
+
+	for (; i + 4 <= count; i += 4) {
+		__m128i* const p = reinterpret_cast<__m128i*>(timers + i);
+
+		const __m128i t = _mm_sub_epi32(_mm_loadu_si128(p), decrement);
+		_mm_storeu_si128(p, t);
+
+		const unsigned stillRunning =
+			(unsigned)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(t, zero)));
+
+		if (stillRunning != 0xF) {
+			expiredCount = AppendExpired(~stillRunning, 4, i, expired, expiredCount);
+		}
+	}
+
+	return AdvanceScalar(timers, i, count, time, expired, expiredCount);
+}
+
+#endif
+
+}
+
+bool IsTimerSimdAvailable()
+{
+	return QUIVER_ANIMATOR_TIMERS_AVX2 != 0 || QUIVER_ANIMATOR_TIMERS_SSE2 != 0;
+}
+
+int AdvanceTimers(
+	gsl::span<TimeUnit::rep> timers,
+	const TimeUnit::rep time,
+	gsl::span<int> expired,
+	const bool useSimd)
+{
+	static_assert(sizeof(Tick) == 4, "The SIMD paths expect 32-bit timers.");
+
+	assert(expired.size() >= timers.size());
+
+	const int count = (int)timers.size();
+
+#if QUIVER_ANIMATOR_TIMERS_AVX2
+	if (useSimd) return AdvanceAvx2(timers.data(), count, time, expired.data());
+#elif QUIVER_ANIMATOR_TIMERS_SSE2
+	if (useSimd) return AdvanceSse2(timers.data(), count, time, expired.data());
+#endif
+
+	return AdvanceScalar(timers.data(), 0, count, time, expired.data(), 0);
+}
+
+}
+
+}
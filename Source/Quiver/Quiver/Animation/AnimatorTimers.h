@@ -0,0 +1,27 @@
+#pragma once
+
+#include <gsl/span>
+
+#include "Quiver/Animation/TimeUnit.h"
+
+namespace qvr {
+
+namespace Animation
+{
+
+// AVX2 is used if it was available at compile time, otherwise SSE2 if that was.
+bool IsTimerSimdAvailable();
+
+// Subtracts time from every timer, and writes the index of each timer that has run out
+// (is now <= 0) to expired, in ascending order. Returns how many ran out.
+// expired must be at least as long as timers.
+// Turning off useSimd is for comparing against.
+int AdvanceTimers(
+	gsl::span<TimeUnit::rep> timers,
+	const TimeUnit::rep time,
+	gsl::span<int> expired,
+	const bool useSimd = IsTimerSimdAvailable());
+
+}
+
+}
@@ -1,5 +1,6 @@
 #include "Animators.h"
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <set>
@@ -11,6 +12,7 @@
 
 #include "Quiver/Animation/AnimationData.h"
 #include "Quiver/Animation/AnimationLibraryGui.h"
+#include "Quiver/Animation/AnimatorTimers.h"
 #include "Quiver/Misc/ImGuiHelpers.h"
 #include "Quiver/Misc/JsonHelpers.h"
 #include "Quiver/Misc/Logging.h"
@@ -45,9 +47,12 @@ bool AnimatorCollection::RemoveAnimation(const AnimationId id)
 	{
 		std::vector<AnimatorId> animatorsToRemove;
 
-		for (const auto& animator : animators.states) {
-			if (animator.second.currentAnimation == id) {
-				animatorsToRemove.push_back(animator.first);
+		// Some of them might finish on their own.
+		CatchUpAll();
+
+		for (unsigned i = 0; i < animators.ids.size(); i++) {
+			if (animators.currentAnimations[i] == id) {
+				animatorsToRemove.push_back(AnimatorId(animators.ids.GetKey(i)));
 			}
 		}
 
@@ -64,12 +69,6 @@ bool AnimatorCollection::RemoveAnimation(const AnimationId id)
 	return animations.Remove(id);
 }
 
-AnimatorId AnimatorCollection::Animators::GetNextAnimatorId() {
-	lastId = AnimatorId(lastId.GetValue() + 1);
-	// TODO: Check for lastId == Invalid and increment if so.
-	return lastId;
-}
-
 AnimatorId AnimatorCollection::Add(
 	AnimatorTarget & target,
 	const AnimatorStartSetting& startSetting)
@@ -80,24 +79,23 @@ AnimatorId AnimatorCollection::Add(
 
 	const int frameIndex = 0;
 
-	const AnimatorId newAnimatorId = animators.GetNextAnimatorId();
+	const AnimatorId newAnimatorId = AnimatorId(animators.ids.Insert());
 
-	animators.states[newAnimatorId] =
-		AnimatorState(
-			startSetting.m_AnimationId,
-			frameIndex,
-			animators.hotStates.size(),
-			target,
-			startSetting.m_RepeatSetting);
+	animators.timeLeftInFrame.push_back(animations.GetTime(startSetting.m_AnimationId, frameIndex).count());
+	animators.currentFrames.push_back(frameIndex);
+	animators.repeatCounts.push_back(0);
+	animators.currentAnimations.push_back(startSetting.m_AnimationId);
+	animators.repeatSettings.push_back(startSetting.m_RepeatSetting);
+	animators.targets.push_back(&target);
+	animators.queuedAnimations.emplace_back();
+	animators.caughtUpSteps.push_back(stepEnds.size());
 
-	animators.hotStates.emplace_back(
-		newAnimatorId,
-		animations.GetTime(startSetting.m_AnimationId, 0));
+	target.animator = newAnimatorId;
 
 	// Update target.
 	SetViews(
 		target.views,
-		animations.GetRects(startSetting.m_AnimationId, 0));
+		animations.GetRects(startSetting.m_AnimationId, frameIndex));
 
 	animationReferenceCounts[startSetting.m_AnimationId]++;
 
@@ -110,48 +108,63 @@ bool AnimatorCollection::Remove(const AnimatorId id)
 
 	// TODO: Add logging.
 
-	if (animators.states.count(id) == 0) return false;
+	const int index = Find(id);
 
-	{
-		const AnimatorState& animator = animators.states[id];
+	if (index < 0) return false;
 
-		animationReferenceCounts[animator.currentAnimation]--;
+	RemoveAt(index);
 
-		// swap...
-		std::iter_swap(
-			animators.hotStates.begin() + animator.index,
-			animators.hotStates.end() - 1);
+	return true;
+}
 
-		// Update the AnimatorState whose hot state was swapped, so that
-		// it knows the new location of its hot state in the array.
-		const AnimatorId idOfMovedAnimator =
-			animators.hotStates[animator.index].animatorId;
-		animators.states.at(idOfMovedAnimator).index = animator.index;
+namespace {
 
-		// ...and pop!
-		animators.hotStates.pop_back();
+// Moves the last element into v[index], like SlotIndex::RemoveAt does with its keys.
+template<typename T>
+void SwapAndPop(std::vector<T>& v, const int index)
+{
+	if (index != (int)v.size() - 1) {
+		v[index] = std::move(v.back());
 	}
+	v.pop_back();
+}
 
-	animators.states.erase(id);
+}
 
-	return true;
+void AnimatorCollection::RemoveAt(const int index)
+{
+	animationReferenceCounts[animators.currentAnimations[index]]--;
+
+	// The target keeps showing its last frame, but the animation's rects can go now.
+	KeepFirstView(animators.targets[index]->views);
+
+	SwapAndPop(animators.timeLeftInFrame, index);
+	SwapAndPop(animators.currentFrames, index);
+	SwapAndPop(animators.repeatCounts, index);
+	SwapAndPop(animators.currentAnimations, index);
+	SwapAndPop(animators.repeatSettings, index);
+	SwapAndPop(animators.targets, index);
+	SwapAndPop(animators.queuedAnimations, index);
+	SwapAndPop(animators.caughtUpSteps, index);
+
+	animators.ids.RemoveAt(index);
 }
 
 void AnimatorCollection::AnimatorGui(const AnimatorId id)
 {
-	if (!Exists(id)) {
-		ImGui::Text("Animator #%u does not exist", id);
+	const int index = Find(id);
+
+	if (index < 0) {
+		ImGui::Text("Animator #%llu does not exist", (unsigned long long)id.GetValue());
 		return;
 	}
 
-	const AnimatorState& animator = animators.states[id];
-
-	ImGui::Text("Animation:  \t#%u", animator.currentAnimation);
-	ImGui::Text("Target Rect:\t0x%08X", animator.target);
+	ImGui::Text("Animation:  \t#%u", animators.currentAnimations[index].GetValue());
+	ImGui::Text("Target Rect:\t0x%p", (void*)animators.targets[index]);
 
 	{
-		const int numFrames = (int)animations.GetFrameCount(animator.currentAnimation);
-		int frameIndex = (int)animator.currentFrame;
+		const int numFrames = (int)animations.GetFrameCount(animators.currentAnimations[index]);
+		int frameIndex = animators.currentFrames[index];
 		if (ImGui::SliderInt("Current Frame", &frameIndex, 0, numFrames - 1))
 			SetFrame(id, frameIndex);
 	}
@@ -159,55 +172,65 @@ void AnimatorCollection::AnimatorGui(const AnimatorId id)
 
 bool AnimatorCollection::ClearAnimationQueue(const AnimatorId id)
 {
-	if (!Exists(id)) return false;
+	const int index = Find(id);
 
-	AnimatorState& animator = animators.states[id];
+	if (index < 0) return false;
 
-	animator.queuedAnimations.clear();
+	animators.queuedAnimations[index].clear();
 
 	return true;
 }
 
 bool AnimatorCollection::SetAnimation(const AnimatorId animatorId, const AnimatorStartSetting& startSetting, const bool clearQueue)
 {
-	if (!Exists(animatorId)) return false;
+	const int index = Find(animatorId);
+
+	if (index < 0) return false;
 	if (!animations.Contains(startSetting.m_AnimationId)) return false;
 
-	AnimatorState& animator = animators.states[animatorId];
+	SetAnimationAt(index, startSetting, clearQueue);
+
+	return true;
+}
 
+void AnimatorCollection::SetAnimationAt(
+	const int index,
+	const AnimatorStartSetting& startSetting,
+	const bool clearQueue,
+	const bool updateTarget)
+{
 	// Decrease refcount on current animation.
-	animationReferenceCounts[animator.currentAnimation]--;
+	animationReferenceCounts[animators.currentAnimations[index]]--;
 	// Increase refcount on new animation.
 	animationReferenceCounts[startSetting.m_AnimationId]++;
 
-	animator.currentAnimation = startSetting.m_AnimationId;
-	animator.currentFrame = 0;
-	animator.repeatCount = 0;
-	animator.repeatSetting = startSetting.m_RepeatSetting;
+	animators.currentAnimations[index] = startSetting.m_AnimationId;
+	animators.currentFrames[index] = 0;
+	animators.repeatCounts[index] = 0;
+	animators.repeatSettings[index] = startSetting.m_RepeatSetting;
 
 	if (clearQueue) {
-		animator.queuedAnimations.clear();
+		animators.queuedAnimations[index].clear();
 	}
 
-	SetViews(
-		animator.target->views,
-		animations.GetRects(animator.currentAnimation, animator.currentFrame));
-
-	animators.hotStates[animator.index].timeLeftInFrame
-		= animations.GetTime(
-			animator.currentAnimation,
-			animator.currentFrame);
+	if (updateTarget) {
+		SetViews(
+			animators.targets[index]->views,
+			animations.GetRects(startSetting.m_AnimationId, 0));
+	}
 
-	return true;
+	animators.timeLeftInFrame[index] = animations.GetTime(startSetting.m_AnimationId, 0).count();
 }
 
 bool AnimatorCollection::SetTarget(const AnimatorId id, AnimatorTarget & newTarget)
 {
-	if (!Exists(id)) return false;
+	const int index = Find(id);
+
+	if (index < 0) return false;
 
-	AnimatorState& animator = animators.states[id];
+	animators.targets[index] = &newTarget;
 
-	animator.target = &newTarget;
+	newTarget.animator = id;
 
 	return true;
 }
@@ -219,13 +242,14 @@ bool AnimatorCollection::QueueAnimation(const AnimatorId id, const AnimatorStart
 
 	const auto logCtx = "AnimatorCollection::QueueAnimation:";
 
-	if (!Exists(id)) {
+	const int index = Find(id);
+
+	if (index < 0) {
 		log->error("{} Animator {} does not exist.", logCtx, id);
 		return false;
 	}
 
-	animators.states[id].queuedAnimations.push_back(
-		pendingAnimation);
+	animators.queuedAnimations[index].push_back(pendingAnimation);
 
 	return true;
 }
@@ -233,13 +257,13 @@ bool AnimatorCollection::QueueAnimation(const AnimatorId id, const AnimatorStart
 AnimationId AnimatorCollection::GetAnimation(const AnimatorId animatorId) const
 {
 	assert(Exists(animatorId));
-	return animators.states.at(animatorId).currentAnimation;
+	return animators.currentAnimations[Find(animatorId)];
 }
 
 unsigned AnimatorCollection::GetFrame(const AnimatorId animatorId) const
 {
 	assert(Exists(animatorId));
-	return animators.states.at(animatorId).currentFrame;
+	return animators.currentFrames[Find(animatorId)];
 }
 
 bool AnimatorCollection::SetFrame(
@@ -248,106 +272,359 @@ bool AnimatorCollection::SetFrame(
 {
 	if (frameIndex < 0) return false;
 
-	if (!Exists(id)) return false;
+	const int index = Find(id);
 
-	AnimatorState& animator = animators.states[id];
+	if (index < 0) return false;
 
-	if (frameIndex >= animations.GetFrameCount(animator.currentAnimation))
+	const AnimationId animation = animators.currentAnimations[index];
+
+	if (frameIndex >= animations.GetFrameCount(animation))
 		return false;
 
-	animator.currentFrame = frameIndex;
+	animators.currentFrames[index] = frameIndex;
 
 	SetViews(
-		animator.target->views,
-		animations.GetRects(animator.currentAnimation, animator.currentFrame));
+		animators.targets[index]->views,
+		animations.GetRects(animation, frameIndex));
 
-	animators.hotStates[animator.index].timeLeftInFrame =
-		animations.GetTime(
-			animator.currentAnimation, 
-			animator.currentFrame);
+	animators.timeLeftInFrame[index] = animations.GetTime(animation, frameIndex).count();
 
 	return true;
 }
 
 using namespace std::chrono_literals;
 
+namespace {
+
+// Every lazy Animator is caught up at least once every this many steps.
+const unsigned RebaseSteps = 256;
+
+}
+
 void AnimatorCollection::Animate(const TimeUnit time) {
 	// because this system doesn't support rewinding.
 	assert(time >= TimeUnit::zero());
 
-	for (auto& animatorHotState : animators.hotStates) {
-		animatorHotState.timeLeftInFrame -= time;
+	if (lazy) {
+		stepEnds.push_back((stepEnds.empty() ? logStart : stepEnds.back()) + time.count());
+
+		longestLoggedStep = std::max(longestLoggedStep, time.count());
+
+		RebaseStepLog();
+
+		return;
+	}
+
+	const int count = animators.ids.size();
+
+	// Only grows, so that stepping doesn't allocate.
+	if ((int)animators.expired.size() < count) {
+		animators.expired.resize(count);
 	}
 
-	// select entries for which timeLeftInFrame <= 0:
-	std::vector<AnimatorId> animatorsToUpdate;
+	const int expiredCount =
+		Animation::AdvanceTimers(
+			animators.timeLeftInFrame,
+			time.count(),
+			animators.expired);
+
+	// Removing an Animator moves another one, so wait until the end.
+	animators.finished.clear();
+
+	for (int e = 0; e < expiredCount; e++) {
+		const int i = animators.expired[e];
 
-	for (auto& animatorHotState : animators.hotStates) {
-		if (animatorHotState.timeLeftInFrame <= TimeUnit::zero()) {
-			animatorsToUpdate.push_back(animatorHotState.animatorId);
+		if (!NextFrame(i, true)) {
+			animators.finished.push_back(AnimatorId(animators.ids.GetKey(i)));
 		}
 	}
 
-	std::vector<AnimatorId> animatorsToRemove;
+	for (const AnimatorId animatorId : animators.finished) {
+		Remove(animatorId);
+	}
+}
+
+bool AnimatorCollection::NextFrame(const int i, const bool updateTarget)
+{
+	const AnimationId animation = animators.currentAnimations[i];
 
-	for (auto animatorId : animatorsToUpdate) {
-		AnimatorState& animator = animators.states.at(animatorId);
+	int& currentFrame = animators.currentFrames[i];
 
-		animator.currentFrame = 
-			(animator.currentFrame + 1) % animations.GetFrameCount(animator.currentAnimation);
+	currentFrame = (currentFrame + 1) % animations.GetFrameCount(animation);
 
-		// This Animator is returning to the beginning of the Animation.
-		if (animator.currentFrame == 0)
-		{
-			const AnimatorRepeatSetting repeatSetting =
-				animator.repeatSetting;
+	// This Animator is returning to the beginning of the Animation.
+	if (currentFrame == 0)
+	{
+		const AnimatorRepeatSetting repeatSetting = animators.repeatSettings[i];
 
-			if (repeatSetting != AnimatorRepeatSetting::Forever)
+		if (repeatSetting != AnimatorRepeatSetting::Forever)
+		{
+			if (animators.repeatCounts[i] >= repeatSetting.GetRepeatCount())
 			{
-				if (animator.repeatCount >= repeatSetting.GetRepeatCount())
-				{
-					if (animator.queuedAnimations.empty())
-					{
-						animatorsToRemove.push_back(animatorId);
-					}
-					else
-					{
-						const bool clearQueue = false;
-
-						if (!SetAnimation(
-							animatorId,
-							animator.queuedAnimations.front(),
-							clearQueue))
-						{
-							animatorsToRemove.push_back(animatorId);
-						}
-
-						// Pop the front of the queue.
-						animator.queuedAnimations.erase(
-							animator.queuedAnimations.begin());
-					}
-
-					continue;
+				std::vector<AnimatorStartSetting>& queue = animators.queuedAnimations[i];
+
+				if (queue.empty()) return false;
+
+				const bool clearQueue = false;
+
+				const bool started = animations.Contains(queue.front().m_AnimationId);
+
+				if (started) {
+					SetAnimationAt(i, queue.front(), clearQueue, updateTarget);
 				}
 
-				animator.repeatCount++;
+				// Pop the front of the queue.
+				queue.erase(queue.begin());
+
+				return started;
 			}
+
+			animators.repeatCounts[i]++;
 		}
+	}
 
-		// Update target.
+	if (updateTarget) {
 		SetViews(
-			animator.target->views,
-			animations.GetRects(animator.currentAnimation, animator.currentFrame));
+			animators.targets[i]->views,
+			animations.GetRects(animation, currentFrame));
+	}
+
+	// Carry over however far the last frame overran.
+	animators.timeLeftInFrame[i] += animations.GetTime(animation, currentFrame).count();
 
-		animators.hotStates[animator.index].timeLeftInFrame += 
-			animations.GetTime(animator.currentAnimation, animator.currentFrame);
+	return true;
+}
+
+void AnimatorCollection::SetLazy(const bool newLazy)
+{
+	if (newLazy == lazy) return;
+
+	if (newLazy) {
+		lazy = true;
 	}
+	else {
+		ClearStepLog();
 
-	for (auto animatorId : animatorsToRemove) {
-		Remove(animatorId);
+		lazy = false;
+	}
+}
+
+void AnimatorCollection::UpdateTarget(const AnimatorTarget& target) const
+{
+	if (!lazy) return;
+
+	const int index = animators.ids.Find(target.animator.GetValue());
+
+	// The target might have been handed over to another Animator since.
+	if (index < 0 || animators.targets[index] != &target) return;
+
+	Mutable().CatchUp(index);
+}
+
+int AnimatorCollection::Find(const AnimatorId id) const
+{
+	const int index = animators.ids.Find(id.GetValue());
+
+	if (index < 0 || !lazy) return index;
+
+	return Mutable().CatchUp(index);
+}
+
+int AnimatorCollection::CatchUp(const int index)
+{
+	const unsigned stepCount = stepEnds.size();
+
+	unsigned step = animators.caughtUpSteps[index];
+
+	if (step == stepCount) return index;
+
+	animators.caughtUpSteps[index] = stepCount;
+
+	TimeUnit::rep& timeLeft = animators.timeLeftInFrame[index];
+
+	bool changedFrame = false;
+
+	while (step < stepCount) {
+		const std::int64_t stepStart = step == 0 ? logStart : stepEnds[step - 1];
+
+		// Animate would count the time left down by each step's time, and move the
+		// Animator on to its next frame in the first step that leaves it at 0 or below.
+		std::int64_t changeTime = stepStart + timeLeft;
+
+		if (changeTime > stepEnds.back()) {
+			timeLeft -= (TimeUnit::rep)(stepEnds.back() - stepStart);
+			break;
+		}
+
+		const std::int64_t nextChangeTime = changeTime;
+
+		if (timeLeft > 0 && SkipAhead(index, stepStart, changeTime)) {
+			changedFrame = true;
+			break;
+		}
+
+		// It skipped some frames before stopping short.
+		changedFrame = changedFrame || changeTime != nextChangeTime;
+
+		const auto changeStep = std::lower_bound(
+			stepEnds.begin() + step,
+			stepEnds.end(),
+			changeTime);
+
+		timeLeft = (TimeUnit::rep)(changeTime - *changeStep);
+
+		step = (unsigned)(changeStep - stepEnds.begin()) + 1;
+
+		const AnimationId animation = animators.currentAnimations[index];
+
+		if (!NextFrame(index, false)) {
+			// It would have been left showing the last frame of its Animation.
+			if (changedFrame) {
+				SetViews(
+					animators.targets[index]->views,
+					animations.GetRects(animation, animations.GetFrameCount(animation) - 1));
+			}
+
+			RemoveAt(index);
+
+			return -1;
+		}
+
+		changedFrame = true;
+	}
+
+	if (changedFrame) {
+		SetViews(
+			animators.targets[index]->views,
+			animations.GetRects(animators.currentAnimations[index], animators.currentFrames[index]));
+	}
+
+	return index;
+}
+
+// When none of an Animation's frames are shorter than any of the steps, no two of its frame
+// changes can happen in the same step. Each one happens in the first step that ends when
+// or after it would have if time were continuous, and Animate carries over how far the
+// frame overran, so the Animator ends up exactly where it would be in continuous time.
+// That can be worked out from when the frames start, however many loops it takes.
+bool AnimatorCollection::SkipAhead(const int index, const std::int64_t from, std::int64_t& lastLoopEnd)
+{
+	const AnimationId animation = animators.currentAnimations[index];
+
+	const TimeUnit::rep shortestFrame = animations.GetShortestFrameTime(animation).count();
+
+	if (shortestFrame <= 0 || shortestFrame < longestLoggedStep) return false;
+
+	const auto startTimes = animations.GetFrameStartTimes(animation);
+	const int frameCount = (int)startTimes.size() - 1;
+	const std::int64_t loopTime = startTimes[frameCount];
+
+	const std::int64_t to = stepEnds.back();
+
+	TimeUnit::rep& timeLeft = animators.timeLeftInFrame[index];
+	int& currentFrame = animators.currentFrames[index];
+	int& repeatCount = animators.repeatCounts[index];
+
+	// Puts the Animator at the given time from the start of a loop.
+	const auto PlaceInLoop = [&](const std::int64_t time) {
+		currentFrame = 
+			(int)(std::upper_bound(startTimes.begin(), startTimes.end(), time) - startTimes.begin()) - 1;
+		timeLeft = (TimeUnit::rep)(startTimes[currentFrame + 1] - time);
+	};
+
+	// The current frame ends by the end of the log. When does the current loop?
+	const std::int64_t loopEnd = from + timeLeft + (loopTime - startTimes[currentFrame + 1]);
+
+	if (loopEnd > to) {
+		PlaceInLoop(to - (loopEnd - loopTime));
+		return true;
+	}
+
+	// Including the one that ends at loopEnd.
+	const std::int64_t loops = 1 + (to - loopEnd) / loopTime;
+
+	const AnimatorRepeatSetting repeatSetting = animators.repeatSettings[index];
+
+	if (repeatSetting != AnimatorRepeatSetting::Forever) {
+		const int repeatsLeft = repeatSetting.GetRepeatCount() - repeatCount;
+
+		if (loops > repeatsLeft) {
+			repeatCount += repeatsLeft;
+			currentFrame = frameCount - 1;
+			lastLoopEnd = loopEnd + repeatsLeft * loopTime;
+			return false;
+		}
+
+		repeatCount += (int)loops;
+	}
+
+	PlaceInLoop((to - loopEnd) % loopTime);
+
+	return true;
+}
+
+void AnimatorCollection::CatchUpAll()
+{
+	if (!lazy) return;
+
+	// Backwards, so that the Animator that takes the place of one that finishes
+	// has already been caught up.
+	for (int i = (int)animators.ids.size() - 1; i >= 0; i--) {
+		CatchUp(i);
 	}
 }
 
+void AnimatorCollection::RebaseStepLog()
+{
+	const unsigned sliceSize = (animators.ids.size() + RebaseSteps - 1) / RebaseSteps;
+
+	for (unsigned i = 0; i < sliceSize && rebaseCursor < animators.ids.size(); i++) {
+		// One that finishes is replaced by one that hasn't been caught up yet.
+		if (CatchUp(rebaseCursor) >= 0) {
+			rebaseCursor++;
+		}
+	}
+
+	if (rebaseCursor < animators.ids.size()) return;
+
+	rebaseCursor = 0;
+
+	// Ones that were moved behind the cursor might have been missed, so look.
+	const unsigned seenByAll =
+		animators.caughtUpSteps.empty()
+		? stepEnds.size()
+		: *std::min_element(animators.caughtUpSteps.begin(), animators.caughtUpSteps.end());
+
+	if (seenByAll == 0) return;
+
+	logStart = stepEnds[seenByAll - 1];
+
+	stepEnds.erase(stepEnds.begin(), stepEnds.begin() + seenByAll);
+
+	for (unsigned& caughtUpSteps : animators.caughtUpSteps) {
+		caughtUpSteps -= seenByAll;
+	}
+
+	longestLoggedStep = 0;
+
+	for (unsigned i = 0; i < stepEnds.size(); i++) {
+		const std::int64_t stepStart = i == 0 ? logStart : stepEnds[i - 1];
+		longestLoggedStep = std::max(longestLoggedStep, (TimeUnit::rep)(stepEnds[i] - stepStart));
+	}
+}
+
+void AnimatorCollection::ClearStepLog()
+{
+	CatchUpAll();
+
+	stepEnds.clear();
+	logStart = 0;
+	longestLoggedStep = 0;
+	rebaseCursor = 0;
+
+	std::fill(animators.caughtUpSteps.begin(), animators.caughtUpSteps.end(), 0);
+}
+
 void GuiControls(AnimatorCollection& animators, AnimationLibraryEditorData& editorData)
 {
 	ImGui::Text("Num. Animations: %u", animators.GetAnimations().GetCount());
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <unordered_map>
 #include <vector>
 
@@ -12,12 +13,16 @@
 #include "Quiver/Animation/AnimatorId.h"
 #include "Quiver/Animation/Rect.h"
 #include "Quiver/Graphics/ViewBuffer.h"
+#include "Quiver/Misc/SlotMap.h"
 
 namespace qvr {
 
 struct AnimatorTarget {
 	ViewBuffer views;
 
+	// The Animator that writes to views, if any.
+	AnimatorId animator = AnimatorId::Invalid;
+
 	AnimatorTarget() = default;
 
 	AnimatorTarget(const AnimatorTarget&) = delete;
@@ -88,6 +93,8 @@ public:
 	bool RemoveAnimation(const AnimationId id);
 
 	int GetReferenceCount(const AnimationId animation) const { 
+		Mutable().CatchUpAll();
+
 		if (animationReferenceCounts.count(animation) == 0) {
 			return 0;
 		}
@@ -99,14 +106,17 @@ public:
 		AnimatorTarget& target, 
 		const AnimatorStartSetting& startSetting);
 
+	// The target keeps a copy of the first view of the frame it was showing,
+	// as it does when the Animator finishes.
 	bool Remove(const AnimatorId id);
 
 	bool Exists(const AnimatorId id) const {
-		return animators.states.count(id) != 0;
+		return Find(id) >= 0;
 	}
 
 	int GetCount() const { 
-		return animators.states.size(); 
+		Mutable().CatchUpAll();
+		return animators.ids.size(); 
 	}
 
 	void AnimatorGui(const AnimatorId id);
@@ -136,53 +146,88 @@ public:
 
 	void Animate(const Animation::TimeUnit ms);
 
+	// Lazy Animators are only moved on when something asks about them, and only write to
+	// their targets then. Animate notes down how long the step was, and catches up a small
+	// share of the Animators, so that every one is caught up every so often and the log of
+	// steps stays short. Catching up usually skips straight to where the Animator should be,
+	// rather than going through every frame change it missed.
+	// The raycast renderer asks about each fixture it draws through UpdateTarget.
+	// Animators animate just the same either way.
+	void SetLazy(const bool lazy);
+	bool IsLazy() const { return lazy; }
+
+	// Brings the target up to date, if it's written to by a lazy Animator.
+	void UpdateTarget(const AnimatorTarget& target) const;
+
 private:
-	struct AnimatorState {
-		AnimatorState(
-			const AnimationId animation,
-			const int frameIndex,
-			const int index,
-			AnimatorTarget& target,
-			const AnimatorRepeatSetting& repeat)
-			: index(index)
-			, currentFrame(frameIndex)
-			, currentAnimation(animation)
-			, target(&target)
-			, repeatSetting(repeat)
-			, repeatCount(0)
-		{}
-
-		AnimatorState() = default;
-
-		int index;
-		int currentFrame;
-		int repeatCount;
-		AnimationId currentAnimation;
-		AnimatorRepeatSetting repeatSetting;
-		AnimatorTarget* target;
-		std::vector<AnimatorStartSetting> queuedAnimations;
-	};
-
-	struct AnimatorState_Hot {
-		AnimatorState_Hot(
-			const AnimatorId animatorId,
-			const Animation::TimeUnit timeLeft)
-			: animatorId(animatorId)
-			, timeLeftInFrame(timeLeft)
-		{}
-
-		Animation::TimeUnit timeLeftInFrame;
-		AnimatorId animatorId;
-	};
+	// Where the Animator is in the Animators arrays, or -1 if it doesn't exist.
+	// Lazy Animators are caught up first, and can finish doing so.
+	int Find(const AnimatorId id) const;
+
+	// Catching up lazy Animators doesn't change anything that can be seen from outside,
+	// so const functions are allowed to.
+	AnimatorCollection& Mutable() const { return const_cast<AnimatorCollection&>(*this); }
+
+	// Plays the lazy Animator through the steps it hasn't seen yet, and updates its target.
+	// Returns where it is now, or -1 if it finished and was removed.
+	int CatchUp(const int index);
+	void CatchUpAll();
+
+	// Moves a lazy Animator on from the end of the given time to the end of the log in one
+	// go, if it can. Returns false if it stopped short at lastLoopEnd, the frame change that
+	// ends its last repeat, just before which it's left.
+	bool SkipAhead(const int index, const std::int64_t from, std::int64_t& lastLoopEnd);
 
+	// Catches up the next few Animators, and drops the steps that every Animator has seen.
+	void RebaseStepLog();
+
+	// Catches everything up first.
+	void ClearStepLog();
+
+	// Moves the Animator on to its next frame, after its time in the last one ran out.
+	// Returns false if it has finished, in which case it's up to the caller to remove it.
+	bool NextFrame(const int index, const bool updateTarget);
+
+	void SetAnimationAt(
+		const int index,
+		const AnimatorStartSetting& startSetting,
+		const bool clearQueue,
+		const bool updateTarget = true);
+
+	void RemoveAt(const int index);
+
+	// Each Animator's state is spread across these arrays, all at the same index,
+	// so that Animate only pulls in the parts it needs.
 	struct Animators {
-		std::vector<AnimatorState_Hot> hotStates;
-		std::unordered_map<AnimatorId, AnimatorState> states;
-		AnimatorId GetNextAnimatorId();
-	private:
-		AnimatorId lastId = AnimatorId::Invalid;
+		SlotIndex ids;
+
+		// In TimeUnit ticks, packed so that AdvanceTimers can work through them with SIMD.
+		std::vector<Animation::TimeUnit::rep> timeLeftInFrame;
+		std::vector<int> currentFrames;
+		std::vector<int> repeatCounts;
+		std::vector<AnimationId> currentAnimations;
+		std::vector<AnimatorRepeatSetting> repeatSettings;
+		std::vector<AnimatorTarget*> targets;
+		std::vector<std::vector<AnimatorStartSetting>> queuedAnimations;
+		// When lazy, how many of the steps in stepEnds the Animator has caught up with.
+		std::vector<unsigned> caughtUpSteps;
+
+		// Scratch space for Animate, kept so that it doesn't allocate every step.
+		std::vector<int> expired;
+		std::vector<AnimatorId> finished;
 	} animators;
 
+	bool lazy = false;
+
+	// When lazy, the total time at the end of each step in the log, in ascending order,
+	// so that an Animator can find the step its frame runs out in.
+	std::vector<std::int64_t> stepEnds;
+	// The end of the last step that was dropped from the log.
+	std::int64_t logStart = 0;
+	Animation::TimeUnit::rep longestLoggedStep = 0;
+	// RebaseStepLog carries on from here.
+	unsigned rebaseCursor = 0;
+
 	AnimationLibrary animations;
 
 	std::unordered_map<AnimationId, unsigned> animationReferenceCounts;
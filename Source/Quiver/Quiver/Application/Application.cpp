@@ -278,10 +278,24 @@ void from_json(const json& j, ImGuiConfig& config) {
 	config.FontAllowUserScaling = j.value("FontAllowUserScaling", config.FontAllowUserScaling);
 }
 
+void from_json(const nlohmann::json& j, DynamicResolutionSettings& d) {
+	if (!j.is_object()) return;
+
+	d.enabled = j.value("enabled", d.enabled);
+	d.targetFrameTime = j.value("targetFrameTime", d.targetFrameTime);
+	d.minRatio = j.value("minRatio", d.minRatio);
+	d.maxRatio = j.value("maxRatio", d.maxRatio);
+	d.hysteresis = j.value("hysteresis", d.hysteresis);
+	d.maxStep = j.value("maxStep", d.maxStep);
+	d.sampleCount = j.value("sampleCount", d.sampleCount);
+}
+
 void from_json(const nlohmann::json& j, GraphicsSettings& g) {
 	if (!j.is_object()) return;
 
 	g.frameTextureResolutionRatio = j.value("frameTextureResolutionRatio", 1.0f);
+	g.dynamicResolution = j.value("dynamicResolution", g.dynamicResolution);
+	g.pipelinedRendering = j.value("pipelinedRendering", g.pipelinedRendering);
 }
 
 void from_json(const json& j, InitialStateConfig& config) {
@@ -3,6 +3,7 @@
 #include <memory>
 
 #include "GraphicsSettings.h"
+#include "Quiver/Graphics/RenderResources.h"
 #include "Quiver/World/WorldContext.h"
 
 namespace sf {
@@ -21,9 +22,15 @@ class ApplicationStateContext {
 	bool mWindowResized = false;
 
 	float mFrameTextureResolutionRatio = 1.0f;
+
+	DynamicResolutionSettings mDynamicResolutionSettings;
+
+	bool mPipelinedRendering = false;
 	
 	WorldContext mWorldContext;
 
+	RenderResources mRenderResources;
+
 	friend int RunApplication(
 		ApplicationParams params);
 
@@ -38,12 +45,17 @@ public:
 			customComponentTypes, 
 			filterBitNames)
 		, mFrameTextureResolutionRatio(graphicsSettings.frameTextureResolutionRatio)
+		, mDynamicResolutionSettings(graphicsSettings.dynamicResolution)
+		, mPipelinedRendering(graphicsSettings.pipelinedRendering)
 	{}
 
 	auto GetWindow() -> sf::RenderWindow& { return mWindow; }
 	bool WindowResized() { return mWindowResized; }
 	auto GetWorldContext() -> WorldContext& { return mWorldContext; }
+	auto GetRenderResources() -> RenderResources& { return mRenderResources; }
 	auto GetFrameTextureResolutionRatio() -> float& { return mFrameTextureResolutionRatio; }
+	auto GetDynamicResolutionSettings() -> DynamicResolutionSettings& { return mDynamicResolutionSettings; }
+	auto GetPipelinedRendering() -> bool& { return mPipelinedRendering; }
 };
 
 class ApplicationState {
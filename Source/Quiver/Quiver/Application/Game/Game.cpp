@@ -1,5 +1,7 @@
 #include "Game.h"
 
+#include <cmath>
+
 #include <SFML/Audio/Listener.hpp>
 #include <SFML/Graphics/RenderTexture.hpp>
 #include <SFML/Graphics/RenderWindow.hpp>
@@ -27,7 +29,9 @@ Game::Game(ApplicationStateContext& context, std::unique_ptr<World> world)
 	: ApplicationState(context)
 	, mWorld(world.release())
 	, mMouse(context.GetWindow())
+	, mWorldRaycastRenderer(context.GetRenderResources())
 	, mFrameTex(std::make_unique<sf::RenderTexture>())
+	, mDynamicResolution(context.GetDynamicResolutionSettings())
 {
 	if (!mWorld) {
 		mWorld.reset(new World(GetContext().GetWorldContext()));
@@ -56,12 +60,21 @@ void Game::ProcessFrame()
 	using namespace std::chrono_literals;
 
 	if (GetContext().WindowResized()) {
-		const auto newSize = GetContext().GetWindow().getSize();
-		mFrameTex->create(newSize.x, newSize.y);
+		UpdateFrameTexture(
+			*mFrameTex,
+			GetContext().GetWindow().getSize(),
+			GetContext().GetFrameTextureResolutionRatio());
+	}
+
+	if (mDynamicResolution.Update(GetContext().GetFrameTextureResolutionRatio())) {
+		UpdateFrameTexture(
+			*mFrameTex,
+			GetContext().GetWindow().getSize(),
+			GetContext().GetFrameTextureResolutionRatio());
 	}
 
 	// Clamp excessively large delta times.
-	const float delta = std::min(mFrameClock.restart().asSeconds(), 1.0f / 30.0f);
+	const float delta = std::min(mFrameClock.restart().asSeconds(), 0.25f);
 
 	mTimeSinceLastStep += std::chrono::duration<float>(delta);
 
@@ -71,46 +84,74 @@ void Game::ProcessFrame()
 		FreeControl(mDefaultCamera3D, delta);
 	}
 
-	if (mCamera2DFollowCamera3D)
-	{
-		const Camera3D& currentCamera3D = mWorld->GetMainCamera() ? *mWorld->GetMainCamera() : mDefaultCamera3D;
-		mCamera2D.SetPosition(currentCamera3D.GetPosition());
-	}
-
 	const auto timestep = mWorld->GetTimestep();
 
-	// Take a step if 1/60th of a second has passed.
-	if (mTimeSinceLastStep >= timestep)
+	// Take as many fixed-length steps as have built up, up to a limit. If the simulation
+	// can't keep up, it's better for it to slow down than to fall further and further behind.
 	{
-		mTimeSinceLastStep = 0.0s;
+		int stepCount = 0;
 
-		mMouse.OnStep();
-		mKeyboard.Update();
-		mJoysticks.Update();
+		while (mTimeSinceLastStep >= timestep && stepCount < MaxStepsPerFrame)
+		{
+			mTimeSinceLastStep -= timestep;
+			stepCount++;
 
-		// This should be coded at the game level, shouldn't it.
-		if (mKeyboard.JustDown(qvr::KeyboardKey::Escape)) {
-			mPaused = !mPaused;
-			OnTogglePause();
-		}
+			mMouse.OnStep();
+			mKeyboard.Update();
+			mJoysticks.Update();
+
+			// This should be coded at the game level, shouldn't it.
+			if (mKeyboard.JustDown(qvr::KeyboardKey::Escape)) {
+				mPaused = !mPaused;
+				OnTogglePause();
+			}
 
-		if (!mPaused) {
-			qvr::RawInputDevices devices(mMouse, mKeyboard, mJoysticks);
+			if (!mPaused) {
+				qvr::RawInputDevices devices(mMouse, mKeyboard, mJoysticks);
 
-			mWorld->TakeStep(devices);
+				mWorld->TakeStep(devices);
+			}
 		}
 
-		// Render World:
-		{
-			mFrameTex->clear(sf::Color(128, 128, 255));
+		if (stepCount == MaxStepsPerFrame) {
+			mTimeSinceLastStep = std::chrono::duration<float>(
+				std::fmod(mTimeSinceLastStep.count(), timestep.count()));
+		}
+	}
+
+	// Draw everything part of the way between the last step and the next one, 
+	// so that motion stays smooth when the frame rate and step rate don't match.
+	mWorld->SetRenderInterpolation(mPaused ? 1.0f : (mTimeSinceLastStep / timestep));
+
+	const Camera3D renderCamera(
+		mWorld->GetMainCamera() ? *mWorld->GetMainCamera() : mDefaultCamera3D,
+		mWorld->GetMainCamera() ? mWorld->GetRenderInterpolation() : 1.0f);
+
+	if (mCamera2DFollowCamera3D)
+	{
+		mCamera2D.SetPosition(renderCamera.GetPosition());
+	}
+
+	// Render World:
+	{
+		ProfilerScope profilerScope(mDynamicResolution.GetProfiler());
+
+		mFrameTex->clear(sf::Color(128, 128, 255));
 
+		if (GetContext().GetPipelinedRendering()) {
+			mWorld->Render3DPipelined(
+				*mFrameTex,
+				renderCamera,
+				mWorldRaycastRenderer);
+		}
+		else {
 			mWorld->Render3D(
 				*mFrameTex,
-				mWorld->GetMainCamera() ? *mWorld->GetMainCamera() : mDefaultCamera3D,
+				renderCamera,
 				mWorldRaycastRenderer);
-
-			mFrameTex->display();
 		}
+
+		mFrameTex->display();
 	}
 
 	mMouse.OnFrame();
@@ -148,6 +189,9 @@ void Game::ProcessFrame()
 
 	if (mWorld->GetNextWorld())
 	{
+		// The frames in the pipeline refer to the old World's textures.
+		mWorldRaycastRenderer.DiscardFrames();
+
 		mWorld = std::move(mWorld->GetNextWorld());
 	}
 	
@@ -213,6 +257,8 @@ void Game::ProcessGui()
 	}
 
 	if (ImGui::Button("Restart!")) {
+		mWorldRaycastRenderer.DiscardFrames();
+
 		try
 		{
 			// Reload the World back to the state it was in when we entered Game mode.
@@ -236,6 +282,31 @@ void Game::ProcessGui()
 					GetContext().GetFrameTextureResolutionRatio());
 			}
 		}
+		{
+			DynamicResolutionSettings& settings = GetContext().GetDynamicResolutionSettings();
+
+			bool changed = false;
+
+			changed |= ImGui::Checkbox("Dynamic Resolution", &settings.enabled);
+
+			if (settings.enabled) {
+				ImGui::AutoIndent indent;
+				changed |= ImGui::SliderFloat("Target Frame Time (ms)", &settings.targetFrameTime, 1.0f, 50.0f);
+				changed |= ImGui::SliderFloat("Min Resolution", &settings.minRatio, 0.1f, settings.maxRatio);
+				changed |= ImGui::SliderFloat("Max Resolution", &settings.maxRatio, settings.minRatio, 1.0f);
+				changed |= ImGui::SliderFloat("Hysteresis", &settings.hysteresis, 0.0f, 0.5f);
+				ImGui::Text("Average Frame Time: %.2fms", mDynamicResolution.GetProfiler().GetAverage().count());
+			}
+
+			if (changed) {
+				mDynamicResolution.SetSettings(settings);
+			}
+		}
+		{
+			if (ImGui::Checkbox("Pipelined Rendering", &GetContext().GetPipelinedRendering())) {
+				mWorldRaycastRenderer.DiscardFrames();
+			}
+		}
 		{
 			float currentVolume = sf::Listener::getGlobalVolume();
 			if (ImGui::SliderFloat("Global Volume", &currentVolume, 0.0f, 100.0f)) {
@@ -252,6 +323,11 @@ void Game::ProcessGui()
 			if (ImGui::CollapsingHeader("World")) {
 				mWorld->GuiPerformanceInfo();
 			}
+
+			if (ImGui::CollapsingHeader("Raycast Renderer")) {
+				ImGui::AutoIndent indent;
+				mWorldRaycastRenderer.GuiPerformanceInfo();
+			}
 		}
 	}
 
@@ -7,6 +7,7 @@
 #include "Quiver/Application/ApplicationState.h"
 #include "Quiver/Graphics/Camera2D.h"
 #include "Quiver/Graphics/Camera3D.h"
+#include "Quiver/Graphics/DynamicResolution.h"
 #include "Quiver/Graphics/WorldRaycastRenderer.h"
 #include "Quiver/Input/SfmlJoystick.h"
 #include "Quiver/Input/SfmlKeyboard.h"
@@ -56,8 +57,13 @@ private:
 
 	std::chrono::duration<float> mTimeSinceLastStep = std::chrono::seconds(0);
 
+	// Any more steps than this are dropped, and the simulation runs slow.
+	static const int MaxStepsPerFrame = 4;
+
 	std::unique_ptr<sf::RenderTexture> mFrameTex;
 
+	DynamicResolution mDynamicResolution;
+
 	bool mPaused = false;
 
 	qvr::SfmlJoystickSet mJoysticks;
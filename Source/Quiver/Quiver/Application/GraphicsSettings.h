@@ -1,10 +1,17 @@
 #pragma once
 
+#include "Quiver/Graphics/DynamicResolution.h"
+
 namespace qvr {
 
 struct GraphicsSettings
 {
 	float frameTextureResolutionRatio = 1.0f;
+
+	DynamicResolutionSettings dynamicResolution;
+
+	// Cast each frame's rays on a render thread while the next step is taken, at the cost of a frame of latency.
+	bool pipelinedRendering = false;
 };
 
 }
\ No newline at end of file
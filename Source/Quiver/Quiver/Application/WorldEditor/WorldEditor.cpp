@@ -40,6 +40,7 @@ WorldEditor::WorldEditor(ApplicationStateContext & context)
 WorldEditor::WorldEditor(ApplicationStateContext& context, std::unique_ptr<World> world)
 	: ApplicationState(context)
 	, mWorld(std::move(world))
+	, mWorldRaycastRenderer(context.GetRenderResources())
 	, mFrameTex(std::make_unique<sf::RenderTexture>())
 	, mMouse(context.GetWindow())
 {
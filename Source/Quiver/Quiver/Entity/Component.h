@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Quiver/Misc/IndexedRegistry.h"
+
 namespace qvr {
 
 class Entity;
@@ -19,7 +21,14 @@ public:
 	Entity& GetEntity() const { return mEntity; }
 
 private:
+	template<typename T>
+	friend class IndexedRegistry;
+
+	RegistryIndex& GetRegistryIndex() { return mRegistryIndex; }
+
 	Entity& mEntity;
+
+	RegistryIndex mRegistryIndex;
 };
 
 }
\ No newline at end of file
@@ -10,9 +10,11 @@ namespace qvr {
 
 CustomComponentType::CustomComponentType(
 	const std::string typeName,
-	std::function<std::unique_ptr<CustomComponent>(Entity&)> factoryFunc)
+	std::function<std::unique_ptr<CustomComponent>(Entity&)> factoryFunc,
+	const bool stepConcurrent)
 	: mName(typeName),
-	mFactoryFunc(factoryFunc)
+	mFactoryFunc(factoryFunc),
+	mStepConcurrent(stepConcurrent)
 {}
 
 std::unique_ptr<CustomComponent>
@@ -20,7 +22,7 @@ CustomComponentType::CreateInstance(
 	Entity & entity,
 	const nlohmann::json & j)
 {
-	auto instance = mFactoryFunc(entity);
+	auto instance = CreateInstance(entity);
 
 	if (instance) {
 		if (!instance->FromJson(j)) {
@@ -56,12 +56,18 @@ public:
 
 	bool GetRemoveFlag() const { return mRemoveFlag; }
 
+	// True if the CustomComponentType that made this says its OnStep can run on any thread.
+	bool IsStepConcurrent() const { return mStepConcurrent; }
+
 protected:
 	// Signal to the World that this Entity should be removed.
 	void SetRemoveFlag(const bool removeFlag) { mRemoveFlag = removeFlag; }
 
 private:
+	friend class CustomComponentType;
+
 	bool mRemoveFlag = false;
+	bool mStepConcurrent = false;
 };
 
 class CustomComponentEditor
@@ -89,9 +95,14 @@ public:
 
 class CustomComponentType final {
 public:
+	// If stepConcurrent is true, instances' OnSteps are run alongside each other on worker threads.
+	// OnStep must then only touch its own Entity and its components, read-only World state, 
+	// and the World's EntityCommandBuffer. In particular it mustn't add or remove anything 
+	// immediately. HandleInput is always called on the main thread.
 	CustomComponentType(
 		const std::string typeName,
-		std::function<std::unique_ptr<CustomComponent>(Entity&)> factoryFunc);
+		std::function<std::unique_ptr<CustomComponent>(Entity&)> factoryFunc,
+		const bool stepConcurrent = false);
 
 	CustomComponentType(const CustomComponentType&) = delete;
 	CustomComponentType(const CustomComponentType&&) = delete;
@@ -100,16 +111,25 @@ public:
 	CustomComponentType& operator=(const CustomComponentType&&) = delete;
 
 	std::unique_ptr<CustomComponent> CreateInstance(Entity& entity) {
-		return mFactoryFunc(entity);
+		auto instance = mFactoryFunc(entity);
+
+		if (instance) {
+			instance->mStepConcurrent = mStepConcurrent;
+		}
+
+		return instance;
 	}
 
 	std::unique_ptr<CustomComponent> CreateInstance(Entity& entity, const nlohmann::json& j);
 
 	std::string GetName() const { return mName; };
 
+	bool IsStepConcurrent() const { return mStepConcurrent; }
+
 private:
 	std::string mName;
 	std::function<std::unique_ptr<CustomComponent>(Entity&)> mFactoryFunc;
+	bool mStepConcurrent;
 };
 
 class CustomComponentTypeLibrary {
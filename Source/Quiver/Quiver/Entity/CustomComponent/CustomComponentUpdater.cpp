@@ -4,70 +4,95 @@
 
 #include "CustomComponent.h"
 
-#include "Quiver/Misc/FindByAddress.h"
+#include "Quiver/Misc/ThreadPool.h"
 
 namespace qvr {
 
+CustomComponentUpdater::CustomComponentUpdater() {}
+
+CustomComponentUpdater::~CustomComponentUpdater() {}
+
 void CustomComponentUpdater::Update(const std::chrono::duration<float> deltaTime, qvr::RawInputDevices& inputDevices)
 {
+	// Components removed during the update leave holes until the end,
+	// so the ones after them don't get moved around (and skipped or updated twice).
+	m_CustomComponents.DeferRemovals();
+
 	for (m_Index = 0; m_Index < (int)m_CustomComponents.size(); m_Index++)
 	{
-		m_CustomComponents[m_Index].get().HandleInput(inputDevices, deltaTime);
+		if (CustomComponent* customComponent = m_CustomComponents.Get(m_Index)) {
+			customComponent->HandleInput(inputDevices, deltaTime);
+		}
+	}
+
+	// Nothing can be removed while these run, since they can't remove anything immediately.
+	m_ConcurrentComponents.clear();
+
+	const int concurrentCount = m_CustomComponents.size();
+
+	for (int i = 0; i < concurrentCount; i++)
+	{
+		CustomComponent* customComponent = m_CustomComponents.Get(i);
+
+		if (customComponent && customComponent->IsStepConcurrent()) {
+			m_ConcurrentComponents.push_back(customComponent);
+		}
+	}
+
+	if (!m_ConcurrentComponents.empty()) {
+		if (!m_ThreadPool) {
+			// The raycast renderer has a pool of its own, which can be casting on the render
+			// thread while the World steps, so only take half of the hardware threads.
+			m_ThreadPool = std::make_unique<ThreadPool>(
+				std::max(ThreadPool::ResolveThreadCount(0) / 2, 1u));
+		}
+
+		m_ThreadPool->ParallelFor(m_ConcurrentComponents.size(), [this, deltaTime](const int i) {
+			m_ConcurrentComponents[i]->OnStep(deltaTime);
+		});
 	}
 
 	for (m_Index = 0; m_Index < (int)m_CustomComponents.size(); m_Index++)
 	{
-		m_CustomComponents[m_Index].get().OnStep(deltaTime);
+		CustomComponent* customComponent = m_CustomComponents.Get(m_Index);
+
+		if (!customComponent) continue;
+
+		// Components that were registered after the concurrent ones ran still get a step.
+		if (customComponent->IsStepConcurrent() && m_Index < concurrentCount) continue;
+
+		customComponent->OnStep(deltaTime);
 	}
 
 	m_Index = -1;
+
+	m_CustomComponents.ApplyRemovals();
 }
 
 bool CustomComponentUpdater::Register(CustomComponent& customComponent)
 {
-	const auto it = FindByAddress(m_CustomComponents, customComponent);
-
-	if (it != m_CustomComponents.end())
-	{
-		return true;
-	}
-
-	m_CustomComponents.push_back(customComponent);
+	// Registering twice is harmless.
+	m_CustomComponents.Add(customComponent);
 
 	return true;
 }
 
 bool CustomComponentUpdater::Unregister(CustomComponent& customComponent)
 {
-	const auto it = FindByAddress(m_CustomComponents, customComponent);
-
-	if (it != m_CustomComponents.end())
-	{
-		m_CustomComponents.erase(it);
-
-		if (IsCurrentlyUpdating()) {
-			m_Index = std::min(0, m_Index - 1);
-		}
-
-		return true;
-	}
-
-	return false;
+	return m_CustomComponents.Remove(customComponent);
 }
 
 auto CustomComponentUpdater::GetRemoveFlaggers() const -> std::vector<std::reference_wrapper<CustomComponent>>
 {
 	std::vector<std::reference_wrapper<CustomComponent>> flaggers;
 	
-	std::copy_if(
-		std::begin(m_CustomComponents),
-		std::end(m_CustomComponents),
-		std::back_inserter(flaggers),
-		[](auto& c) {
-			return c.get().GetRemoveFlag();
-		});
+	for (CustomComponent* customComponent : m_CustomComponents) {
+		if (customComponent && customComponent->GetRemoveFlag()) {
+			flaggers.push_back(*customComponent);
+		}
+	}
 
 	return flaggers;
 }
 
-}
\ No newline at end of file
+}
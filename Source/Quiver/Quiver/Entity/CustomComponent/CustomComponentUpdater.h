@@ -1,24 +1,38 @@
 #pragma once
 
 #include <chrono>
+#include <functional>
+#include <memory>
 #include <vector>
 
+#include "Quiver/Misc/IndexedRegistry.h"
+
 namespace qvr {
 
 class CustomComponent;
 class RawInputDevices;
+class ThreadPool;
 
 class CustomComponentUpdater
 {
 public:
+	CustomComponentUpdater();
+	~CustomComponentUpdater();
+
+	// Steps components whose types allow it in parallel, then the rest one at a time.
 	void Update(const std::chrono::duration<float> deltaTime, qvr::RawInputDevices& inputDevices);
 	bool Register(CustomComponent& customComponent);
+	// Safe to call from inside Update, including for the component being updated.
 	bool Unregister(CustomComponent& customComponent);
 	bool IsCurrentlyUpdating() const { return m_Index >= 0; }
 	auto GetRemoveFlaggers() const -> std::vector<std::reference_wrapper<CustomComponent>>;
 private:
 	int m_Index = -1;
-	std::vector<std::reference_wrapper<CustomComponent>> m_CustomComponents;
+	IndexedRegistry<CustomComponent> m_CustomComponents;
+
+	// Only created once there's something to step concurrently.
+	std::unique_ptr<ThreadPool> m_ThreadPool;
+	std::vector<CustomComponent*> m_ConcurrentComponents;
 };
 
 }
\ No newline at end of file
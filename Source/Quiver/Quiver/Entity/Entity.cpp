@@ -21,7 +21,6 @@ namespace qvr {
 
 Entity::Entity(World& world, const PhysicsComponentDef& physicsDef)
 	: mWorld(world)
-	, mId(world.GetNextEntityId())
 	, mPhysicsComponent(std::make_unique<PhysicsComponent>(*this, physicsDef))
 {}
 
@@ -53,14 +53,16 @@ public:
 
 	void SetPrefab(std::string prefabName) { mPrefabName = prefabName; };
 
+	// EntityId(0) until the Entity is added to its World.
 	EntityId GetId() const { return mId; }
 
 private:
 	friend class EntityEditor;
+	friend class World;
 
 	World& mWorld;
 	
-	EntityId mId;
+	EntityId mId = EntityId(0);
 
 	std::unique_ptr<PhysicsComponent> mPhysicsComponent;
 	std::unique_ptr<RenderComponent>  mRenderComponent;	
@@ -0,0 +1,168 @@
+#include "EntityCommandBuffer.h"
+
+#include <cassert>
+
+#include "Quiver/Entity/Entity.h"
+#include "Quiver/Entity/CustomComponent/CustomComponent.h"
+#include "Quiver/World/World.h"
+
+namespace qvr {
+
+void EntityCommandBuffer::CreateEntity(
+	nlohmann::json j,
+	const b2Transform* transform,
+	EntityCallback onCreated)
+{
+	Creation creation;
+	creation.m_Json = std::move(j);
+	if (transform) {
+		creation.m_Transform = *transform;
+	}
+	creation.m_OnCreated = std::move(onCreated);
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_Creations.push_back(std::move(creation));
+}
+
+void EntityCommandBuffer::DestroyEntity(const EntityId id)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_Destructions.push_back(id);
+}
+
+void EntityCommandBuffer::AddGraphics(const EntityId id, nlohmann::json renderComponentJson)
+{
+	AddComponentChange(id, ComponentChangeType::AddGraphics, std::move(renderComponentJson));
+}
+
+void EntityCommandBuffer::RemoveGraphics(const EntityId id)
+{
+	AddComponentChange(id, ComponentChangeType::RemoveGraphics);
+}
+
+void EntityCommandBuffer::AddAudio(const EntityId id)
+{
+	AddComponentChange(id, ComponentChangeType::AddAudio);
+}
+
+void EntityCommandBuffer::RemoveAudio(const EntityId id)
+{
+	AddComponentChange(id, ComponentChangeType::RemoveAudio);
+}
+
+void EntityCommandBuffer::AddCustomComponent(const EntityId id, CustomComponentFactory factory)
+{
+	AddComponentChange(
+		id,
+		ComponentChangeType::AddCustomComponent,
+		nlohmann::json(),
+		std::move(factory));
+}
+
+void EntityCommandBuffer::RemoveCustomComponent(const EntityId id)
+{
+	AddComponentChange(id, ComponentChangeType::RemoveCustomComponent);
+}
+
+void EntityCommandBuffer::Apply(World& world)
+{
+	// Take everything out first, so that anything recorded by destructors,
+	// constructors or callbacks from here on goes in the other buffers.
+	std::vector<EntityId>& destructions = m_ApplyingDestructions;
+	std::vector<Creation>& creations = m_ApplyingCreations;
+	std::vector<ComponentChange>& componentChanges = m_ApplyingComponentChanges;
+
+	assert(destructions.empty() && creations.empty() && componentChanges.empty());
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		destructions.swap(m_Destructions);
+		creations.swap(m_Creations);
+		componentChanges.swap(m_ComponentChanges);
+	}
+
+	// An Entity destroyed twice is only found the first time.
+	for (const EntityId id : destructions) {
+		if (Entity* entity = world.GetEntity(id)) {
+			world.RemoveEntityImmediate(*entity);
+		}
+	}
+
+	world.ReserveEntities(creations.size());
+
+	for (Creation& creation : creations) {
+		Entity* entity =
+			world.CreateEntity(
+				creation.m_Json,
+				creation.m_Transform ? &creation.m_Transform.value() : nullptr);
+
+		if (entity && creation.m_OnCreated) {
+			creation.m_OnCreated(*entity);
+		}
+	}
+
+	for (ComponentChange& change : componentChanges) {
+		Entity* entity = world.GetEntity(change.m_Entity);
+
+		if (!entity) continue;
+
+		switch (change.m_Type) {
+		case ComponentChangeType::AddGraphics:
+			if (!entity->GetGraphics()) entity->AddGraphics(change.m_Json);
+			break;
+		case ComponentChangeType::RemoveGraphics:
+			if (entity->GetGraphics()) entity->RemoveGraphics();
+			break;
+		case ComponentChangeType::AddAudio:
+			if (!entity->GetAudio()) entity->AddAudio();
+			break;
+		case ComponentChangeType::RemoveAudio:
+			if (entity->GetAudio()) entity->RemoveAudio();
+			break;
+		case ComponentChangeType::AddCustomComponent:
+			// Get rid of the old one before the new one registers itself.
+			entity->AddCustomComponent(nullptr);
+			entity->AddCustomComponent(change.m_Factory(*entity));
+			break;
+		case ComponentChangeType::RemoveCustomComponent:
+			entity->AddCustomComponent(nullptr);
+			break;
+		}
+	}
+
+	destructions.clear();
+	creations.clear();
+	componentChanges.clear();
+}
+
+bool EntityCommandBuffer::empty() const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Destructions.empty() && m_Creations.empty() && m_ComponentChanges.empty();
+}
+
+void EntityCommandBuffer::clear()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_Destructions.clear();
+	m_Creations.clear();
+	m_ComponentChanges.clear();
+}
+
+void EntityCommandBuffer::AddComponentChange(
+	const EntityId id,
+	const ComponentChangeType type,
+	nlohmann::json j,
+	CustomComponentFactory factory)
+{
+	ComponentChange change;
+	change.m_Entity = id;
+	change.m_Type = type;
+	change.m_Json = std::move(j);
+	change.m_Factory = std::move(factory);
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_ComponentChanges.push_back(std::move(change));
+}
+
+}
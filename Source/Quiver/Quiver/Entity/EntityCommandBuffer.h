@@ -0,0 +1,99 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <Box2D/Common/b2Math.h>
+#include <function2.hpp>
+#include <json.hpp>
+#include <optional.hpp>
+
+#include "Quiver/Entity/EntityId.h"
+
+namespace qvr {
+
+class CustomComponent;
+class Entity;
+class World;
+
+// Records Entity creation, destruction and component changes to be made later, all at once,
+// when it's safe to. Nothing gets added to or removed from the World (or its b2World) while
+// something might be iterating over it, like during a step or a contact callback.
+// Changes to Entities that no longer exist by the time they're applied are ignored.
+// Commands can be recorded from any thread, but only applied from one.
+class EntityCommandBuffer
+{
+public:
+	using EntityCallback = fu2::unique_function<void(Entity&)>;
+	using CustomComponentFactory = fu2::unique_function<std::unique_ptr<CustomComponent>(Entity&)>;
+
+	// Like World::CreateEntity. onCreated gets the new Entity, if it could be created.
+	void CreateEntity(
+		nlohmann::json j,
+		const b2Transform* transform = nullptr,
+		EntityCallback onCreated = nullptr);
+
+	void DestroyEntity(const EntityId id);
+
+	void AddGraphics(const EntityId id, nlohmann::json renderComponentJson);
+	void RemoveGraphics(const EntityId id);
+
+	void AddAudio(const EntityId id);
+	void RemoveAudio(const EntityId id);
+
+	// Replaces any CustomComponent the Entity already has.
+	void AddCustomComponent(const EntityId id, CustomComponentFactory factory);
+	void RemoveCustomComponent(const EntityId id);
+
+	// Destroys, then creates, then changes components, each in the order they were recorded.
+	// Anything recorded while applying is left for next time.
+	void Apply(World& world);
+
+	bool empty() const;
+
+	void clear();
+
+private:
+	struct Creation {
+		nlohmann::json m_Json;
+		std::experimental::optional<b2Transform> m_Transform;
+		EntityCallback m_OnCreated;
+	};
+
+	enum class ComponentChangeType {
+		AddGraphics,
+		RemoveGraphics,
+		AddAudio,
+		RemoveAudio,
+		AddCustomComponent,
+		RemoveCustomComponent
+	};
+
+	struct ComponentChange {
+		EntityId m_Entity = EntityId(0);
+		ComponentChangeType m_Type;
+		nlohmann::json m_Json;
+		CustomComponentFactory m_Factory;
+	};
+
+	void AddComponentChange(
+		const EntityId id,
+		const ComponentChangeType type,
+		nlohmann::json j = nlohmann::json(),
+		CustomComponentFactory factory = nullptr);
+
+	mutable std::mutex m_Mutex;
+
+	std::vector<EntityId> m_Destructions;
+	std::vector<Creation> m_Creations;
+	std::vector<ComponentChange> m_ComponentChanges;
+
+	// What Apply is working through. Swapped with the ones above, and cleared
+	// afterwards, so that both sets keep their capacity between steps.
+	std::vector<EntityId> m_ApplyingDestructions;
+	std::vector<Creation> m_ApplyingCreations;
+	std::vector<ComponentChange> m_ApplyingComponentChanges;
+};
+
+}
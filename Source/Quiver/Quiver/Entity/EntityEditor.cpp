@@ -22,7 +22,10 @@ void EntityEditor::GuiControls() {
 	auto log = spdlog::get("console");
 	assert(log);
 
-	ImGui::Text("Entity ID: %d", m_Entity.GetId().get());
+	ImGui::Text(
+		"Entity ID: %u (Generation %u)",
+		GetSlotIndex(m_Entity.GetId().get()),
+		GetSlotGeneration(m_Entity.GetId().get()));
 	ImGui::Text("Entity Address: %p", (void*)&m_Entity);
 
 	ImGui::Text(
@@ -2,8 +2,11 @@
 
 #include <named_type.hpp>
 
+#include "Quiver/Misc/SlotMap.h"
+
 namespace qvr {
 
-using EntityId = fluent::NamedType<int, struct EntityIdTag, fluent::Comparable, fluent::Hashable>;
+// The key to the Entity's slot in its World. EntityId(0) never refers to an Entity.
+using EntityId = fluent::NamedType<SlotMapKey, struct EntityIdTag, fluent::Comparable, fluent::Hashable>;
 
 }
\ No newline at end of file
@@ -30,6 +30,8 @@ PhysicsComponent::PhysicsComponent(Entity& entity, const PhysicsComponentDef& de
 		mBody.reset(body);
 	}
 
+	SavePreviousTransform();
+
 	{
 		// Attach the fixture to the body.
 		b2Fixture* f = nullptr;
@@ -47,6 +49,20 @@ PhysicsComponent::~PhysicsComponent()
 	mBody->SetUserData(nullptr);
 };
 
+void PhysicsComponent::SavePreviousTransform()
+{
+	mPreviousTransform = mBody->GetTransform();
+}
+
+b2Transform PhysicsComponent::GetInterpolatedTransform(const float alpha) const
+{
+	if (alpha >= 1.0f) {
+		return mBody->GetTransform();
+	}
+
+	return Physics::Interpolate(mPreviousTransform, mBody->GetTransform(), alpha);
+}
+
 namespace
 {
 
@@ -36,9 +36,18 @@ public:
 
 	b2Body& GetBody() { return *mBody; }
 
+	// World calls this before every step, so that rendering can 
+	// interpolate between where the body was and where it is now.
+	void SavePreviousTransform();
+
+	// alpha = 0 gives the transform before the last step, alpha = 1 the current one.
+	b2Transform GetInterpolatedTransform(const float alpha) const;
+
 private:
 	Physics::b2BodyUniquePtr mBody;
 
+	b2Transform mPreviousTransform;
+
 };
 
 }
\ No newline at end of file
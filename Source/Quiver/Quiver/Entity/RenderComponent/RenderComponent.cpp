@@ -92,6 +92,7 @@ bool RenderComponent::ToJson(nlohmann::json & j) const
 	j["GroundOffset"] = GetGroundOffset();
 	j["Colour"] = ColourUtils::ToJson(GetColor());
 	j["SpriteRadius"] = GetSpriteRadius();
+	j["Opaque"] = IsOpaque();
 
 	if (GetTexture()) {
 		j["Texture"] = mTextureFilename;
@@ -118,7 +119,7 @@ bool RenderComponent::ToJson(nlohmann::json & j) const
 		}
 		else if (GetTexture())
 		{
-			GetViews().views[0].ToJson(j["TextureRect"]);
+			GetView(GetViews()).ToJson(j["TextureRect"]);
 		}
 	}
 
@@ -131,6 +132,7 @@ bool RenderComponent::FromJson(const nlohmann::json & j)
 
 	SetHeight(j.value<float>("Height", 1.0f));
 	SetGroundOffset(j.value<float>("GroundOffset", 0.0f));
+	SetOpaque(j.value<bool>("Opaque", false));
 
 	if (j.count("Colour") &&
 		!ColourUtils::DeserializeSFColorFromJson(
@@ -161,6 +163,7 @@ bool RenderComponent::FromJson(const nlohmann::json & j)
 			std::string filename = j["Texture"].get<std::string>();
 			if (filename.length() > 0) {
 				mFixtureRenderData->mTexture = GetEntity().GetWorld().GetTextureLibrary().LoadTexture(filename);
+				mFixtureRenderData->mAtlasRegion = GetEntity().GetWorld().GetTextureLibrary().GetAtlasRegion(filename);
 				if (GetTexture()) {
 					mTextureFilename = filename;
 					SetView(
@@ -219,7 +222,9 @@ void RenderComponent::UpdateDetachedBodyPosition()
 {
 	assert(IsDetached());
 
-	const b2Vec2 position = GetEntity().GetPhysics()->GetPosition();
+	const b2Vec2 position = 
+		GetEntity().GetPhysics()->GetInterpolatedTransform(
+			GetEntity().GetWorld().GetRenderInterpolation()).p;
 
 	mDetachedBody->SetTransform(position, mDetachedBody->GetAngle());
 
@@ -279,6 +284,8 @@ void RenderComponent::SetDetached(const bool detached)
 			newFixture->SetUserData(mFixtureRenderData.get());
 		}
 
+		mFixtureRenderData->mDetached = true;
+
 		GetEntity().GetWorld().RegisterDetachedRenderComponent(*this);
 	}
 	else
@@ -289,6 +296,8 @@ void RenderComponent::SetDetached(const bool detached)
 		
 		mDetachedBody.reset();
 
+		mFixtureRenderData->mDetached = false;
+
 		GetFixture()->SetUserData(mFixtureRenderData.get());
 	}
 }
@@ -320,6 +329,7 @@ bool RenderComponent::SetTexture(const std::string& filename)
 	std::shared_ptr<sf::Texture> texture = GetTextureLibrary(*this).LoadTexture(filename);
 
 	this->mFixtureRenderData->mTexture = texture;
+	this->mFixtureRenderData->mAtlasRegion = GetTextureLibrary(*this).GetAtlasRegion(filename);
 
 	if (texture)
 	{
@@ -337,9 +347,17 @@ bool RenderComponent::SetTexture(const std::string& filename)
 
 void RenderComponent::RemoveTexture() {
 	this->mFixtureRenderData->mTexture = nullptr;
+	this->mFixtureRenderData->mAtlasRegion = TextureRegion();
 	this->mTextureFilename.clear();
 }
 
+const ViewBuffer& RenderComponent::GetViews() const
+{
+	GetAnimators(*this).UpdateTarget(mFixtureRenderData->GetAnimatorTarget());
+
+	return mFixtureRenderData->GetViews();
+}
+
 void RenderComponent::SetTextureRect(const Animation::Rect& rect)
 {
 	// If there is no Animator, set the texture rect to the size of the texture.
@@ -38,11 +38,13 @@ public:
 	float GetObjectAngle()            const { return mFixtureRenderData->GetObjectAngle(); }
 	const b2Vec2& GetSpritePosition() const { return mFixtureRenderData->GetSpritePosition(); }
 	const sf::Color GetColor()        const { return mFixtureRenderData->GetColor(); }
+	bool IsOpaque()                   const { return mFixtureRenderData->IsOpaque(); }
 
 	void SetHeight      (const float height)       { mFixtureRenderData->mHeight = height; }
 	void SetGroundOffset(const float groundOffset) { mFixtureRenderData->mGroundOffset = groundOffset; }
 	void SetObjectAngle (const float radians)      { mFixtureRenderData->mObjectAngle = radians; }
 	void SetColor       (const sf::Color& color)   { mFixtureRenderData->mBlendColor = color; }
+	void SetOpaque      (const bool opaque)        { mFixtureRenderData->mOpaque = opaque; }
 	void SetSpriteRadius(const float spriteRadius);
 
 	const sf::Texture* GetTexture()         const { return mFixtureRenderData->GetTexture(); }
@@ -50,7 +52,8 @@ public:
 	bool SetTexture(const std::string& filename);
 	void RemoveTexture();
 
-	const ViewBuffer& GetViews() const { return mFixtureRenderData->GetViews(); }
+	// Up to date, even if the Animator is lazy.
+	const ViewBuffer& GetViews() const;
 
 	void SetTextureRect(const Animation::Rect& rect);
 
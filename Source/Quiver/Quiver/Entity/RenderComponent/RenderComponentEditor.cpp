@@ -64,6 +64,13 @@ void RenderComponentEditor::GuiControls()
 		}
 	}
 
+	{
+		bool opaque = m_RenderComponent.IsOpaque();
+		if (ImGui::Checkbox("Opaque", &opaque)) {
+			m_RenderComponent.SetOpaque(opaque);
+		}
+	}
+
 	{
 		sf::Color c = m_RenderComponent.GetColor();
 		ColourUtils::ImGuiColourEdit("Colour", c);
@@ -82,7 +89,7 @@ void RenderComponentEditor::GuiControls()
 			else {
 				ImGui::Image(*m_RenderComponent.GetTexture());
 
-				const Animation::Rect rect = m_RenderComponent.GetViews().views[0];
+				const Animation::Rect rect = GetView(m_RenderComponent.GetViews());
 
 				ImGui::Image(*m_RenderComponent.GetTexture(),
 					sf::FloatRect(
@@ -119,7 +126,7 @@ void RenderComponentEditor::GuiControls()
 		}
 
 		if (animSystem.Exists(m_RenderComponent.GetAnimatorId())) {
-			ImGui::Text("Animator ID:\t%u", m_RenderComponent.GetAnimatorId());
+			ImGui::Text("Animator ID:\t%llu", (unsigned long long)m_RenderComponent.GetAnimatorId().GetValue());
 			animSystem.AnimatorGui(m_RenderComponent.GetAnimatorId());
 
 			if (ImGui::Button("Remove Animator")) {
@@ -132,7 +139,7 @@ void RenderComponentEditor::GuiControls()
 			if (ImGui::CollapsingHeader("Set Texture Rect")) {
 				ImGui::AutoIndent indent2;
 
-				Animation::Rect rect = m_RenderComponent.GetViews().views[0];
+				Animation::Rect rect = GetView(m_RenderComponent.GetViews());
 
 				int corner[2] = { rect.left, rect.top };
 				if (ImGui::InputInt2("Top Left (X, Y)", corner)) {
@@ -8,6 +8,7 @@
 #include <spdlog/spdlog.h>
 
 #include "Quiver/Input/Xbox360Controller.h"
+#include "Quiver/Physics/PhysicsUtils.h"
 #include "Quiver/World/World.h"
 
 namespace qvr {
@@ -17,15 +18,34 @@ namespace qvr {
 
 Camera3D::Camera3D(const Camera3D& other)
 	: mTransform(other.mTransform)
+	, mPreviousTransform(other.mPreviousTransform)
 	, mHeight(other.mHeight)
 	, mBaseHeight(other.mBaseHeight)
+	, mPitchRadians(other.mPitchRadians)
 	, mFovRadians(other.mFovRadians)
 {}
 
+// This one stands in for other while rendering, so it does take the overlays.
+Camera3D::Camera3D(const Camera3D& other, const float alpha)
+	: mTransform(
+		alpha < 1.0f ?
+		Physics::Interpolate(other.mPreviousTransform, other.mTransform, alpha) :
+		other.mTransform)
+	, mPreviousTransform(other.mPreviousTransform)
+	, mHeight(other.mHeight)
+	, mBaseHeight(other.mBaseHeight)
+	, mPitchRadians(other.mPitchRadians)
+	, mFovRadians(other.mFovRadians)
+	, mOverlayDrawer(other.mOverlayDrawer)
+	, mDepthTestedOverlayDrawer(other.mDepthTestedOverlayDrawer)
+{}
+
 Camera3D& Camera3D::operator=(const Camera3D& other) {
 	mTransform = other.mTransform;
+	mPreviousTransform = other.mPreviousTransform;
 	mHeight = other.mHeight;
 	mBaseHeight = other.mBaseHeight;
+	mPitchRadians = other.mPitchRadians;
 	mFovRadians = other.mFovRadians;
 	return *this;
 }
@@ -3,6 +3,8 @@
 #include <Box2D/Common/b2Math.h>
 #include <json.hpp>
 
+#include "Quiver/Misc/IndexedRegistry.h"
+
 namespace sf {
 class RenderTarget;
 class Window;
@@ -10,6 +12,7 @@ class Window;
 
 namespace qvr {
 
+class RaycastDepthBuffer;
 class World;
 
 class Camera3D {
@@ -22,6 +25,10 @@ public:
 	{}
 
 	Camera3D(const Camera3D&);
+
+	// A copy of other, overlays and all, placed between where it was 
+	// before the last step (alpha = 0) and where it is now (alpha = 1).
+	Camera3D(const Camera3D& other, const float alpha);
 	Camera3D(const Camera3D&&) = delete;
 
 	Camera3D& operator=(const Camera3D&);
@@ -42,6 +49,22 @@ public:
 		}
 	}
 
+	// An OverlayDrawer that can depth-test what it draws against the 3D view.
+	using DepthTestedOverlayDrawer = std::function<void(sf::RenderTarget&, const RaycastDepthBuffer&)>;
+
+	void SetDepthTestedOverlayDrawer(DepthTestedOverlayDrawer overlayDrawer) {
+		mDepthTestedOverlayDrawer = overlayDrawer;
+	}
+
+	// Draws both kinds of overlay.
+	void DrawOverlay(sf::RenderTarget& target, const RaycastDepthBuffer& depthBuffer) const {
+		DrawOverlay(target);
+
+		if (mDepthTestedOverlayDrawer) {
+			mDepthTestedOverlayDrawer(target, depthBuffer);
+		}
+	}
+
 	const b2Vec2& GetPosition() const { return mTransform.p; }
 	const b2Vec2 GetForwards() const { return mTransform.q.GetYAxis(); }
 	const b2Vec2 GetRightwards() const { return mTransform.q.GetXAxis(); }
@@ -78,8 +101,17 @@ public:
 		mTransform.p += displacement;
 	}
 
+	// World calls this before every step for each of its cameras.
+	void SavePreviousTransform() { mPreviousTransform = mTransform; }
+
 private:
+	template<typename T>
+	friend class IndexedRegistry;
+
+	RegistryIndex& GetRegistryIndex() { return mRegistryIndex; }
+
 	b2Transform mTransform = b2Transform(b2Vec2_zero, b2Rot(0.0f));
+	b2Transform mPreviousTransform = b2Transform(b2Vec2_zero, b2Rot(0.0f));
 
 	float mHeight = 0.5f;
 	float mBaseHeight = 0.5f;
@@ -87,6 +119,10 @@ private:
 	float mFovRadians = b2_pi / 2;
 
 	OverlayDrawer mOverlayDrawer;
+	DepthTestedOverlayDrawer mDepthTestedOverlayDrawer;
+
+	// Where this is in its World's list of cameras.
+	RegistryIndex mRegistryIndex;
 
 };
 
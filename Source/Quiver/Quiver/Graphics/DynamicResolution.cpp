@@ -0,0 +1,59 @@
+#include "DynamicResolution.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace qvr {
+
+DynamicResolution::DynamicResolution(const DynamicResolutionSettings& settings)
+	: mSettings(settings)
+	, mProfiler(std::max(settings.sampleCount, 1u))
+{}
+
+bool DynamicResolution::Update(float& ratio)
+{
+	if (!mSettings.enabled) return false;
+
+	// Wait until every sample in the buffer was taken at the current resolution.
+	if (mProfiler.GetFrontIndex() - mChangeFrontIndex < mProfiler.BufferSize()) return false;
+
+	const float average = mProfiler.GetAverage().count();
+	const float target = mSettings.targetFrameTime;
+
+	if (average <= 0.0f) return false;
+
+	if (average <= target * (1.0f + mSettings.hysteresis) &&
+		average >= target * (1.0f - mSettings.hysteresis))
+	{
+		return false;
+	}
+
+	// The ratio scales both dimensions, so render time goes with its square.
+	float newRatio = ratio * std::sqrt(target / average);
+
+	newRatio = std::max(newRatio, ratio - mSettings.maxStep);
+	newRatio = std::min(newRatio, ratio + mSettings.maxStep);
+	newRatio = std::max(newRatio, mSettings.minRatio);
+	newRatio = std::min(newRatio, mSettings.maxRatio);
+
+	// Already as far as it can go.
+	if (std::abs(newRatio - ratio) < 0.001f) return false;
+
+	ratio = newRatio;
+
+	mChangeFrontIndex = mProfiler.GetFrontIndex();
+
+	return true;
+}
+
+void DynamicResolution::SetSettings(const DynamicResolutionSettings& settings)
+{
+	if (settings.sampleCount != mSettings.sampleCount) {
+		mProfiler.Resize(std::max(settings.sampleCount, 1u));
+		mChangeFrontIndex = 0;
+	}
+
+	mSettings = settings;
+}
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Quiver/Misc/Profiler.h"
+
+namespace qvr {
+
+struct DynamicResolutionSettings
+{
+	bool enabled = false;
+
+	// How long rendering a frame should take, in milliseconds.
+	float targetFrameTime = 10.0f;
+
+	// Bounds for the frame texture resolution ratio.
+	float minRatio = 0.25f;
+	float maxRatio = 1.0f;
+
+	// Frame times within this fraction of the target are left alone, so the
+	// resolution doesn't flip back and forth between two sizes.
+	float hysteresis = 0.15f;
+
+	// The most the ratio can change in one go.
+	float maxStep = 0.1f;
+
+	// Frames to average over, and to wait for after each change.
+	unsigned sampleCount = 30;
+};
+
+// Picks a frame texture resolution ratio that keeps the render time near a target.
+class DynamicResolution
+{
+public:
+	DynamicResolution(const DynamicResolutionSettings& settings);
+
+	// Render timings go here. Use a ProfilerScope around whatever the ratio affects.
+	Profiler& GetProfiler() { return mProfiler; }
+
+	void AddSample(const Profiler::SampleUnit sample) { mProfiler.AddSample(sample); }
+
+	// Adjusts ratio if the average frame time has been out of bounds for long enough.
+	// Returns true if it changed, in which case the frame texture needs recreating.
+	bool Update(float& ratio);
+
+	const DynamicResolutionSettings& GetSettings() const { return mSettings; }
+
+	void SetSettings(const DynamicResolutionSettings& settings);
+
+private:
+	DynamicResolutionSettings mSettings;
+
+	Profiler mProfiler;
+
+	// The Profiler's front index when the ratio last changed.
+	int mChangeFrontIndex = 0;
+};
+
+}
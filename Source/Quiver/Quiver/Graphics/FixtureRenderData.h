@@ -6,6 +6,7 @@
 #include <SFML/Graphics/Texture.hpp>
 
 #include "Quiver/Animation/Animators.h"
+#include "Quiver/Graphics/TextureAtlas.h"
 
 namespace qvr
 {
@@ -20,12 +21,17 @@ class FixtureRenderData
 	float mGroundOffset = 0.0f;
 	float mSpriteRadius = 0.5f;
 	float mObjectAngle = 0.0f;
+	bool mOpaque = false;
+	bool mDetached = false;
 	b2Vec2 mSpritePosition;
 
 	sf::Color mBlendColor = sf::Color(255, 255, 255, 255);
 
 	std::shared_ptr<sf::Texture> mTexture;
 
+	// Where mTexture's pixels are in the TextureLibrary's atlas, if they are.
+	TextureRegion mAtlasRegion;
+
 	AnimatorTarget mTextureRects;
 
 public:
@@ -34,13 +40,28 @@ public:
 	float GetSpriteRadius() const { return mSpriteRadius; }
 	float GetObjectAngle() const { return mObjectAngle; }
 
+	// Nothing behind an opaque fixture is visible, so rays stop at it.
+	bool IsOpaque() const { return mOpaque; }
+
+	// A flat sprite that always faces the camera.
+	bool IsDetached() const { return mDetached; }
+
 	const b2Vec2& GetSpritePosition() const { return mSpritePosition; }
 
 	sf::Color GetColor() const { return mBlendColor; }
 
 	const sf::Texture* GetTexture() const { return mTexture.get(); }
 
+	// Null if the texture isn't in an atlas page.
+	const sf::Texture* GetAtlasPage() const { return mAtlasRegion.mPage.get(); }
+
+	// Add this to texture rects to get the same pixels from the atlas page.
+	sf::Vector2i GetAtlasOffset() const { return mAtlasRegion.mOffset; }
+
 	const ViewBuffer& GetViews() const { return mTextureRects.views; }
+
+	// For bringing the views up to date, if they're animated lazily.
+	const AnimatorTarget& GetAnimatorTarget() const { return mTextureRects; }
 };
 
 }
\ No newline at end of file
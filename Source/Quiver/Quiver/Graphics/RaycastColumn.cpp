@@ -0,0 +1,98 @@
+#include "RaycastColumn.h"
+
+#include <cmath>
+
+#include "Quiver/Graphics/Camera3D.h"
+#include "Quiver/Graphics/FixtureRenderData.h"
+#include "Quiver/Graphics/ViewBuffer.h"
+
+namespace qvr {
+
+FixtureColumnInfo CalculateFixtureColumnInfo(
+	const FixtureRenderData& renderData,
+	const Camera3D& camera,
+	const sf::Vector2u& targetSize,
+	const bool useTextureAtlas)
+{
+	FixtureColumnInfo info;
+
+	info.m_TextureRect =
+		renderData.GetViews().viewCount <= 1 ?
+		GetView(renderData.GetViews()) :
+		CalculateView(
+			renderData.GetViews(),
+			renderData.GetObjectAngle(),
+			[&camera, &renderData]() {
+				const b2Vec2 disp = renderData.GetSpritePosition() - camera.GetPosition();
+				return b2Atan2(disp.y, disp.x) + b2_pi;
+			}());
+
+	{
+		const b2Vec2 perp(-camera.GetForwards().y, camera.GetForwards().x);
+
+		info.m_SpriteLeft = renderData.GetSpritePosition() - (renderData.GetSpriteRadius() * perp);
+
+		info.m_TexelsPerMetre =
+			(info.m_TextureRect.right - info.m_TextureRect.left) / (renderData.GetSpriteRadius() * 2);
+	}
+
+	{
+		// At a distance of 1 metre, a vertical metre is enough pixels in height to fill the screen,
+		// so everything in the vertical scales with targetSize.y / distance.
+		const float screenHeight = (float)targetSize.y;
+
+		const float offset =
+			renderData.GetGroundOffset() +
+			(renderData.GetHeight() - 1.0f) +
+			(camera.GetHeightOffset() * 2.0f);
+
+		info.m_Horizon = (screenHeight / 2) + (float)GetPitchOffsetInPixels(camera, targetSize.y);
+		info.m_TopScale = screenHeight * (-renderData.GetHeight() - offset) / 2;
+		info.m_BottomScale = screenHeight * (renderData.GetHeight() - offset) / 2;
+	}
+
+	info.m_BlendColor = renderData.GetColor();
+	info.m_Texture = renderData.GetTexture();
+
+	if (useTextureAtlas && renderData.GetAtlasPage()) {
+		const sf::Vector2i offset = renderData.GetAtlasOffset();
+
+		info.m_Texture = renderData.GetAtlasPage();
+		info.m_TextureRect.left += offset.x;
+		info.m_TextureRect.right += offset.x;
+		info.m_TextureRect.top += offset.y;
+		info.m_TextureRect.bottom += offset.y;
+	}
+	info.m_Opaque = renderData.IsOpaque();
+
+	return info;
+}
+
+RaycastColumn CalculateColumn(
+	const FixtureColumnInfo& info,
+	const Camera3D& camera,
+	const b2Vec2& point,
+	const b2Vec2& normal,
+	const int screenX)
+{
+	const b2Vec2 displacement = point - camera.GetPosition();
+	const float  distance = b2Dot(displacement, camera.GetForwards());
+
+	const float inverseDistance = 1.0f / std::abs(distance);
+
+	RaycastColumn output;
+	output.m_BlendColor = info.m_BlendColor;
+	output.m_Texture = info.m_Texture;
+	output.m_X = (float)screenX;
+	output.m_Top = info.m_Horizon + (info.m_TopScale * inverseDistance);
+	output.m_Bottom = info.m_Horizon + (info.m_BottomScale * inverseDistance);
+	output.m_Distance = distance;
+	output.m_U = ((point - info.m_SpriteLeft).Length() * info.m_TexelsPerMetre) + info.m_TextureRect.left;
+	output.m_VTop = (float)info.m_TextureRect.top;
+	output.m_VBottom = (float)info.m_TextureRect.bottom;
+	output.m_Normal = sf::Vector2f(normal.x, normal.y);
+	output.m_Opaque = info.m_Opaque;
+	return output;
+}
+
+}
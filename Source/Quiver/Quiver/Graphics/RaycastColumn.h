@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Box2D/Common/b2Math.h>
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include "Quiver/Animation/Rect.h"
+
+namespace sf {
+class Texture;
+}
+
+namespace qvr {
+
+class Camera3D;
+class FixtureRenderData;
+
+// A vertical strip of a fixture, as seen by one screen column.
+struct RaycastColumn {
+	float m_Top;
+	float m_Bottom;
+	float m_X;
+	float m_Distance;
+	float m_U;
+	float m_VTop;
+	float m_VBottom;
+	sf::Color m_BlendColor;
+	sf::Vector2f m_Normal;
+	const sf::Texture* m_Texture;
+	bool m_Opaque;
+};
+
+// Everything about a fixture's RaycastColumns that doesn't depend on where the ray hit it.
+// Calculating this once per fixture per frame saves repeating it for every column.
+struct FixtureColumnInfo {
+	Animation::Rect m_TextureRect;
+
+	// Where the sprite starts, from the camera's point of view.
+	b2Vec2 m_SpriteLeft;
+
+	// Converts distance from m_SpriteLeft to a horizontal texel coordinate.
+	float m_TexelsPerMetre;
+
+	// Top and bottom are (m_Horizon + m_TopScale / distance) and (m_Horizon + m_BottomScale / distance).
+	float m_Horizon;
+	float m_TopScale;
+	float m_BottomScale;
+
+	sf::Color m_BlendColor;
+	const sf::Texture* m_Texture;
+	bool m_Opaque;
+};
+
+// If useTextureAtlas is set and the fixture's texture is in an atlas page, 
+// the info refers to the page instead, with the texture rect moved to match.
+FixtureColumnInfo CalculateFixtureColumnInfo(
+	const FixtureRenderData& renderData,
+	const Camera3D& camera,
+	const sf::Vector2u& targetSize,
+	const bool useTextureAtlas = true);
+
+RaycastColumn CalculateColumn(
+	const FixtureColumnInfo& info,
+	const Camera3D& camera,
+	const b2Vec2& point,
+	const b2Vec2& normal,
+	const int screenX);
+
+}
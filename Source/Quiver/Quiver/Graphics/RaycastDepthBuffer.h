@@ -0,0 +1,65 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace qvr {
+
+// The nearest opaque surface WorldRaycastRenderer found in each screen column.
+// Anything drawn over the 3D view afterwards can be depth-tested against it
+// on the CPU, without querying Box2D again.
+class RaycastDepthBuffer {
+public:
+	// Also clears the buffer.
+	void Resize(const unsigned width) {
+		m_Depths.resize(width);
+		m_Tops.resize(width);
+		m_Bottoms.resize(width);
+		Clear();
+	}
+
+	// Makes every column infinitely deep.
+	void Clear() {
+		std::fill(m_Depths.begin(), m_Depths.end(), std::numeric_limits<float>::infinity());
+		std::fill(m_Tops.begin(), m_Tops.end(), 0.0f);
+		std::fill(m_Bottoms.begin(), m_Bottoms.end(), 0.0f);
+	}
+
+	void SetColumn(const unsigned x, const float depth, const float top, const float bottom) {
+		m_Depths[x] = depth;
+		m_Tops[x] = top;
+		m_Bottoms[x] = bottom;
+	}
+
+	unsigned GetWidth() const { return m_Depths.size(); }
+
+	// Distance to the nearest opaque surface in column x, or infinity if there isn't one.
+	float GetDepth(const unsigned x) const { return m_Depths[x]; }
+
+	// The rows [top, bottom) that the nearest opaque surface in column x covers.
+	float GetTop(const unsigned x) const { return m_Tops[x]; }
+	float GetBottom(const unsigned x) const { return m_Bottoms[x]; }
+
+	// True if something at the given distance in column x is behind an opaque surface.
+	// Treats the surface as infinitely tall.
+	bool IsHidden(const int x, const float distance) const {
+		if (x < 0 || x >= (int)GetWidth()) return false;
+
+		return distance > m_Depths[x];
+	}
+
+	// As above, but only hidden if row y is within the surface's span.
+	bool IsHidden(const int x, const float y, const float distance) const {
+		if (!IsHidden(x, distance)) return false;
+
+		return y >= m_Tops[x] && y < m_Bottoms[x];
+	}
+
+private:
+	std::vector<float> m_Depths;
+	std::vector<float> m_Tops;
+	std::vector<float> m_Bottoms;
+};
+
+}
@@ -0,0 +1,168 @@
+#include "RenderResources.h"
+
+#include <cassert>
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Glsl.hpp>
+#include <SFML/Graphics/Shader.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
+#include "Quiver/Misc/Logging.h"
+
+namespace qvr {
+
+namespace {
+
+const char* vertexShaderRawText = R"(
+
+#version 130
+
+uniform vec4 ambientLightColor;
+
+uniform vec4 directionalLightColor;
+uniform vec2 directionalLightDirection;
+
+uniform vec4 fogColor;
+uniform float fogMaxIntensity;
+uniform float fogMaxDistance;
+uniform float fogMinDistance;
+
+out vec4 appliedFogColor;
+out vec4 appliedDirectionalLightColor;
+
+void main() {
+	float fogIntensity = 
+		min(
+			((min(
+				max(
+					gl_Vertex.z, 
+					fogMinDistance), 
+				fogMaxDistance) 
+			- fogMinDistance) 
+			/ (fogMaxDistance - fogMinDistance)),
+			fogMaxIntensity);
+	appliedFogColor = fogColor * fogIntensity;
+
+	appliedDirectionalLightColor = 
+		directionalLightColor * 
+		clamp(dot(vec2(gl_Normal), -directionalLightDirection), 0.0f, 1.0f);
+
+	gl_Position = ftransform();
+	gl_Position.z = 0.0f;
+	
+	gl_FrontColor = ambientLightColor * gl_Color;
+	
+	gl_TexCoord[0] = gl_TextureMatrix[0] * gl_MultiTexCoord0;
+}
+
+)";
+
+const char* fragmentShaderRawText = R"(
+
+#version 130	
+
+uniform sampler2D texture;
+
+in vec4 appliedFogColor;
+in vec4 appliedDirectionalLightColor;
+
+void main() {
+	vec4 blendColor = gl_Color;
+
+	vec4 textureColor = texture2D(texture, gl_TexCoord[0].xy);
+
+	gl_FragColor = (blendColor * textureColor) + appliedFogColor + appliedDirectionalLightColor;
+}
+
+)";
+
+bool SameLighting(const AmbientLight& a, const AmbientLight& b) {
+	return a.mColor == b.mColor;
+}
+
+bool SameLighting(const DirectionalLight& a, const DirectionalLight& b) {
+	return a.GetDirection() == b.GetDirection() && a.GetColor() == b.GetColor();
+}
+
+bool SameLighting(const Fog& a, const Fog& b) {
+	return
+		a.GetColor() == b.GetColor() &&
+		a.GetMaxIntensity() == b.GetMaxIntensity() &&
+		a.GetMinDistance() == b.GetMinDistance() &&
+		a.GetMaxDistance() == b.GetMaxDistance();
+}
+
+}
+
+RenderResources::RenderResources() = default;
+
+RenderResources::~RenderResources() = default;
+
+sf::Shader& RenderResources::GetRaycastShader()
+{
+	if (!mRaycastShader) {
+		mRaycastShader = std::make_unique<sf::Shader>();
+
+		const bool result = mRaycastShader->loadFromMemory(vertexShaderRawText, fragmentShaderRawText);
+
+		if (!result) {
+			GetConsoleLogger()->error("Couldn't compile the raycast shader.");
+		}
+
+		assert(result);
+	}
+
+	return *mRaycastShader;
+}
+
+const sf::Texture& RenderResources::GetDefaultTexture()
+{
+	if (!mDefaultTexture) {
+		mDefaultTexture = std::make_unique<sf::Texture>();
+
+		mDefaultTexture->create(1, 1);
+		// Make it white.
+		{
+			auto c = sf::Color::White;
+			mDefaultTexture->update(&c.r);
+		}
+	}
+
+	return *mDefaultTexture;
+}
+
+bool RenderResources::SetLighting(
+	const AmbientLight& ambientLight,
+	const DirectionalLight& directionalLight,
+	const Fog& fog)
+{
+	if (mLightingUploaded &&
+		SameLighting(ambientLight, mAmbientLight) &&
+		SameLighting(directionalLight, mDirectionalLight) &&
+		SameLighting(fog, mFog))
+	{
+		return false;
+	}
+
+	sf::Shader& shader = GetRaycastShader();
+
+	shader.setUniform("ambientLightColor", sf::Glsl::Vec4(ambientLight.mColor));
+
+	shader.setUniform("directionalLightDirection",
+		sf::Glsl::Vec2(directionalLight.GetDirection().x, directionalLight.GetDirection().y));
+	shader.setUniform("directionalLightColor", sf::Glsl::Vec4(directionalLight.GetColor()));
+
+	shader.setUniform("fogColor", sf::Glsl::Vec4(fog.GetColor()));
+	shader.setUniform("fogMaxIntensity", fog.GetMaxIntensity());
+	shader.setUniform("fogMaxDistance", fog.GetMaxDistance());
+	shader.setUniform("fogMinDistance", fog.GetMinDistance());
+
+	mAmbientLight = ambientLight;
+	mDirectionalLight = directionalLight;
+	mFog = fog;
+	mLightingUploaded = true;
+
+	return true;
+}
+
+}
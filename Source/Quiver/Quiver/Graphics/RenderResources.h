@@ -0,0 +1,51 @@
+#pragma once
+
+#include <memory>
+
+#include "Quiver/Graphics/Fog.h"
+#include "Quiver/Graphics/Light.h"
+
+namespace sf {
+class Shader;
+class Texture;
+}
+
+namespace qvr {
+
+// GPU resources that WorldRaycastRenderers share, so that they are created once
+// rather than once per renderer or per frame. Everything is created on first use,
+// so a RenderResources can be constructed before there is a GL context.
+class RenderResources
+{
+public:
+	RenderResources();
+	~RenderResources();
+
+	RenderResources(const RenderResources&) = delete;
+	RenderResources& operator=(const RenderResources&) = delete;
+
+	// The GLSL program that draws raycast columns.
+	sf::Shader& GetRaycastShader();
+
+	// 1x1 white, for untextured columns.
+	const sf::Texture& GetDefaultTexture();
+
+	// Uploads the lighting uniforms to the raycast shader, unless they're
+	// the same as last time. Returns true if they were uploaded.
+	bool SetLighting(
+		const AmbientLight& ambientLight,
+		const DirectionalLight& directionalLight,
+		const Fog& fog);
+
+private:
+	std::unique_ptr<sf::Shader> mRaycastShader;
+	std::unique_ptr<sf::Texture> mDefaultTexture;
+
+	// What the raycast shader's lighting uniforms were last set to.
+	bool mLightingUploaded = false;
+	AmbientLight mAmbientLight;
+	DirectionalLight mDirectionalLight;
+	Fog mFog;
+};
+
+}
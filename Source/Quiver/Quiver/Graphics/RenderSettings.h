@@ -8,16 +8,48 @@ struct RenderSettings
 {
 	float m_RayLength = 50.0f;
 
+	// Number of threads the raycast stage is split across. 0 means one per hardware thread.
+	int m_ThreadCount = 0;
+
+	// Submit runs of same-textured columns with one draw call instead of one call per column.
+	bool m_BatchColumns = true;
+
+	// Only test each ray against fixtures whose bounds overlap its column, instead of the whole world.
+	bool m_FrustumCull = true;
+
+	// Only re-cast the columns that could have changed since the last frame. Needs m_FrustumCull.
+	bool m_ReuseColumns = false;
+
+	// Draw textures from the TextureLibrary's atlas pages, where possible, so that fewer binds are needed.
+	bool m_TextureAtlas = true;
+
+	// Draw the columns on the CPU instead of with OpenGL.
+	bool m_SoftwareRasterizer = false;
+
 	RenderSettings() = default;
 
 	RenderSettings(const nlohmann::json& j) noexcept {
 		if (j.is_object()) {
 			m_RayLength = j.value<float>("RayLength", 50.0f);
+			m_ThreadCount = j.value<int>("ThreadCount", 0);
+			m_BatchColumns = j.value<bool>("BatchColumns", true);
+			m_FrustumCull = j.value<bool>("FrustumCull", true);
+			m_ReuseColumns = j.value<bool>("ReuseColumns", false);
+			m_TextureAtlas = j.value<bool>("TextureAtlas", true);
+			m_SoftwareRasterizer = j.value<bool>("SoftwareRasterizer", false);
 		}
 	}
 
 	nlohmann::json ToJson() const {
-		return nlohmann::json{ {"RayLength", m_RayLength} };
+		return nlohmann::json{ 
+			{"RayLength", m_RayLength},
+			{"ThreadCount", m_ThreadCount},
+			{"BatchColumns", m_BatchColumns},
+			{"FrustumCull", m_FrustumCull},
+			{"ReuseColumns", m_ReuseColumns},
+			{"TextureAtlas", m_TextureAtlas},
+			{"SoftwareRasterizer", m_SoftwareRasterizer}
+		};
 	}
 };
 
@@ -325,7 +325,8 @@ void Sky::SkyLayer::EditorImGuiControls()
 
 void Sky::SkyLayer::Render(sf::RenderTarget & target, const Camera3D & camera) const
 {
-	const sf::Vector2f targetSize = sf::Vector2f((float)target.getSize().x, (float)target.getSize().y);
+	// The view's size rather than the target's, so that the sky can be drawn into part of it.
+	const sf::Vector2f targetSize = target.getView().getSize();
 
 	const float tau = b2_pi * 2.0f;
 
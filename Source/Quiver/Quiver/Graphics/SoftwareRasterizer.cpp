@@ -0,0 +1,351 @@
+#include "SoftwareRasterizer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define QUIVER_SOFTWARE_RASTERIZER_SSE2 1
+#include <emmintrin.h>
+#else
+#define QUIVER_SOFTWARE_RASTERIZER_SSE2 0
+#endif
+
+#include "Quiver/Graphics/RaycastColumn.h"
+
+namespace qvr {
+
+namespace {
+
+const sf::Uint8 White[4] = { 255, 255, 255, 255 };
+
+// What the shader works out per vertex. Both vertices of a column share
+// the same distance and normal, so it's the same all the way down.
+struct ColumnShading {
+	// gl_FrontColor: ambient light times the column's blend colour.
+	float m_Multiply[4];
+	// Fog plus directional light.
+	float m_Add[4];
+};
+
+ColumnShading CalculateShading(const RaycastColumn& column, const SoftwareLighting& lighting)
+{
+	const float ToFloat = 1.0f / 255.0f;
+
+	const sf::Color ambient = lighting.m_Ambient.mColor;
+	const sf::Color fog = lighting.m_Fog.GetColor();
+	const sf::Color directional = lighting.m_Directional.GetColor();
+
+	const float fogIntensity = lighting.m_Fog.GetIntensity(column.m_Distance);
+
+	const b2Vec2 lightDirection = lighting.m_Directional.GetDirection();
+
+	const float directionalIntensity =
+		std::min(std::max(
+			-(column.m_Normal.x * lightDirection.x + column.m_Normal.y * lightDirection.y),
+			0.0f), 1.0f);
+
+	const sf::Uint8 ambientChannels[4] = { ambient.r, ambient.g, ambient.b, ambient.a };
+	const sf::Uint8 blendChannels[4] = { column.m_BlendColor.r, column.m_BlendColor.g, column.m_BlendColor.b, column.m_BlendColor.a };
+	const sf::Uint8 fogChannels[4] = { fog.r, fog.g, fog.b, fog.a };
+	const sf::Uint8 directionalChannels[4] = { directional.r, directional.g, directional.b, directional.a };
+
+	ColumnShading shading;
+
+	for (int i = 0; i < 4; i++) {
+		shading.m_Multiply[i] = (ambientChannels[i] * ToFloat) * (blendChannels[i] * ToFloat);
+		shading.m_Add[i] =
+			(fogChannels[i] * ToFloat * fogIntensity) +
+			(directionalChannels[i] * ToFloat * directionalIntensity);
+	}
+
+	return shading;
+}
+
+// Every pixel in a column samples the same column of texels, so find that once.
+struct TexelColumn {
+	const sf::Uint8* m_Texels;
+	int m_Stride;
+	float m_LastRow;
+
+	TexelColumn(const SoftwareTexture& texture, const float u)
+	{
+		if (!texture.m_Pixels) {
+			m_Texels = White;
+			m_Stride = 0;
+			m_LastRow = 0.0f;
+			return;
+		}
+
+		// Nearest neighbour, clamped to the edges, like an sf::Texture that isn't smooth or repeated.
+		const int x = std::min(std::max((int)std::floor(u), 0), (int)texture.m_Width - 1);
+
+		m_Texels = texture.m_Pixels + (x * 4);
+		m_Stride = texture.m_Width * 4;
+		m_LastRow = (float)(texture.m_Height - 1);
+	}
+
+	const sf::Uint8* Sample(const float v) const {
+		// Clamping first means truncating is the same as flooring.
+		return m_Texels + ((int)std::min(std::max(v, 0.0f), m_LastRow) * m_Stride);
+	}
+};
+
+// The fragment shader, followed by premultiplied 'over' blending.
+void ShadeScalar(
+	const ColumnShading& shading,
+	const sf::Uint8* texel,
+	sf::Uint8* destination)
+{
+	const float ToFloat = 1.0f / 255.0f;
+
+	float source[4];
+
+	for (int i = 0; i < 4; i++) {
+		source[i] = (shading.m_Multiply[i] * (texel[i] * ToFloat)) + shading.m_Add[i];
+		source[i] = std::min(std::max(source[i], 0.0f), 1.0f);
+	}
+
+	const float alpha = source[3];
+
+	for (int i = 0; i < 4; i++) {
+		const float premultiplied = (i < 3) ? source[i] * alpha : alpha;
+		const float blended = premultiplied + ((destination[i] * ToFloat) * (1.0f - alpha));
+		destination[i] = (sf::Uint8)(int)((blended * 255.0f) + 0.5f);
+	}
+}
+
+#if QUIVER_SOFTWARE_RASTERIZER_SSE2
+
+inline __m128 LoadPixel(const sf::Uint8* pixel)
+{
+	const __m128i zero = _mm_setzero_si128();
+
+	int packed;
+	std::memcpy(&packed, pixel, sizeof(packed));
+
+	__m128i p = _mm_cvtsi32_si128(packed);
+
+	p = _mm_unpacklo_epi8(p, zero);
+	p = _mm_unpacklo_epi16(p, zero);
+
+	return _mm_mul_ps(_mm_cvtepi32_ps(p), _mm_set1_ps(1.0f / 255.0f));
+}
+
+inline void StorePixel(const __m128 value, sf::Uint8* pixel)
+{
+	__m128i p = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(value, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)));
+
+	p = _mm_packs_epi32(p, p);
+	p = _mm_packus_epi16(p, p);
+
+	const int packed = _mm_cvtsi128_si32(p);
+	std::memcpy(pixel, &packed, sizeof(packed));
+}
+
+// Four neighbouring pixels, one per register.
+inline void LoadPixels(const __m128i packed, __m128 (&pixels)[4])
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 toFloat = _mm_set1_ps(1.0f / 255.0f);
+
+	const __m128i low = _mm_unpacklo_epi8(packed, zero);
+	const __m128i high = _mm_unpackhi_epi8(packed, zero);
+
+	pixels[0] = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero)), toFloat);
+	pixels[1] = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero)), toFloat);
+	pixels[2] = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero)), toFloat);
+	pixels[3] = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero)), toFloat);
+}
+
+inline __m128i StorePixels(const __m128 (&pixels)[4])
+{
+	const __m128 scale = _mm_set1_ps(255.0f);
+	const __m128 half = _mm_set1_ps(0.5f);
+
+	__m128i p[4];
+
+	for (int i = 0; i < 4; i++) {
+		p[i] = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(pixels[i], scale), half));
+	}
+
+	return _mm_packus_epi16(_mm_packs_epi32(p[0], p[1]), _mm_packs_epi32(p[2], p[3]));
+}
+
+// TexelColumn::Sample(V(row)) for rows [row, row + 4), with the texel rows worked out
+// four at a time. The sums are done in the same order as V's, so they round the same way.
+// SSE2 can't gather, so the texels themselves are fetched one by one.
+inline __m128i SampleTexels(
+	const TexelColumn& texels,
+	const __m128 vTop,
+	const __m128 top,
+	const __m128 texelsPerPixel,
+	const int row)
+{
+	const __m128 rows = _mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32(row), _mm_set_epi32(3, 2, 1, 0)));
+
+	const __m128 v = _mm_add_ps(vTop, _mm_mul_ps(_mm_sub_ps(_mm_add_ps(rows, _mm_set1_ps(0.5f)), top), texelsPerPixel));
+
+	const __m128 clamped = _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(texels.m_LastRow));
+
+	alignas(16) int texelRows[4];
+	_mm_store_si128((__m128i*)texelRows, _mm_cvttps_epi32(clamped));
+
+	int packed[4];
+
+	for (int i = 0; i < 4; i++) {
+		std::memcpy(&packed[i], texels.m_Texels + (texelRows[i] * texels.m_Stride), sizeof(int));
+	}
+
+	return _mm_loadu_si128((const __m128i*)packed);
+}
+
+// Same as ShadeScalar, with one pixel's four channels in one register.
+inline __m128 ShadeSse2(
+	const __m128 multiply,
+	const __m128 add,
+	const __m128 texel,
+	const __m128 destination)
+{
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 alphaMask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+
+	__m128 source = _mm_add_ps(_mm_mul_ps(multiply, texel), add);
+	source = _mm_min_ps(_mm_max_ps(source, zero), one);
+
+	const __m128 alpha = _mm_shuffle_ps(source, source, _MM_SHUFFLE(3, 3, 3, 3));
+
+	// (a, a, a, 1), so that only the colour channels get premultiplied.
+	const __m128 premultiplier = _mm_or_ps(_mm_and_ps(alphaMask, one), _mm_andnot_ps(alphaMask, alpha));
+
+	return
+		_mm_add_ps(
+			_mm_mul_ps(source, premultiplier),
+			_mm_mul_ps(destination, _mm_sub_ps(one, alpha)));
+}
+
+#endif
+
+}
+
+void SoftwareRasterizer::SetSize(const unsigned width, const unsigned height)
+{
+	m_Width = width;
+	m_Height = height;
+
+	m_Pixels.resize(width * height * 4);
+
+	Clear();
+}
+
+void SoftwareRasterizer::Clear()
+{
+	std::fill(m_Pixels.begin(), m_Pixels.end(), 0);
+}
+
+bool SoftwareRasterizer::IsSimdAvailable()
+{
+	return QUIVER_SOFTWARE_RASTERIZER_SSE2 != 0;
+}
+
+void SoftwareRasterizer::Draw(
+	const RaycastColumn& column,
+	const SoftwareTexture& texture,
+	const SoftwareLighting& lighting)
+{
+	const int x = (int)column.m_X;
+
+	if (x < 0 || x >= (int)m_Width) return;
+	if (column.m_Bottom <= column.m_Top) return;
+
+	// A pixel is covered if its centre is.
+	const int firstRow = std::max((int)std::ceil(column.m_Top - 0.5f), 0);
+	const int endRow = std::min((int)std::ceil(column.m_Bottom - 0.5f), (int)m_Height);
+
+	if (firstRow >= endRow) return;
+
+	const ColumnShading shading = CalculateShading(column, lighting);
+
+	const float texelsPerPixel = (column.m_VBottom - column.m_VTop) / (column.m_Bottom - column.m_Top);
+
+	sf::Uint8* const columnPixels = m_Pixels.data() + (x * m_Height * 4);
+
+	const TexelColumn texels(texture, column.m_U);
+
+	auto V = [&column, texelsPerPixel](const int row) {
+		return column.m_VTop + (((row + 0.5f) - column.m_Top) * texelsPerPixel);
+	};
+
+#if QUIVER_SOFTWARE_RASTERIZER_SSE2
+	if (m_UseSimd)
+	{
+		const __m128 multiply = _mm_loadu_ps(shading.m_Multiply);
+		const __m128 add = _mm_loadu_ps(shading.m_Add);
+
+		const __m128 vTop = _mm_set1_ps(column.m_VTop);
+		const __m128 top = _mm_set1_ps(column.m_Top);
+		const __m128 perPixel = _mm_set1_ps(texelsPerPixel);
+
+		int row = firstRow;
+
+		// Four pixels at a time. The four destination pixels are next to each
+		// other, so they're loaded and stored in one go.
+		for (; row + 4 <= endRow; row += 4) {
+			sf::Uint8* const destination = columnPixels + (row * 4);
+
+			__m128 texel[4];
+			LoadPixels(SampleTexels(texels, vTop, top, perPixel, row), texel);
+
+			__m128 pixels[4];
+			LoadPixels(_mm_loadu_si128((const __m128i*)destination), pixels);
+
+			for (int i = 0; i < 4; i++) {
+				pixels[i] = ShadeSse2(multiply, add, texel[i], pixels[i]);
+			}
+
+			_mm_storeu_si128((__m128i*)destination, StorePixels(pixels));
+		}
+
+		for (; row < endRow; row++) {
+			sf::Uint8* const destination = columnPixels + (row * 4);
+
+			StorePixel(
+				ShadeSse2(multiply, add, LoadPixel(texels.Sample(V(row))), LoadPixel(destination)),
+				destination);
+		}
+
+		return;
+	}
+#endif
+
+	for (int row = firstRow; row < endRow; row++) {
+		ShadeScalar(shading, texels.Sample(V(row)), columnPixels + (row * 4));
+	}
+}
+
+sf::Color SoftwareRasterizer::GetPixel(const unsigned x, const unsigned y) const
+{
+	assert(x < m_Width);
+	assert(y < m_Height);
+
+	const sf::Uint8* pixel = m_Pixels.data() + (((x * m_Height) + y) * 4);
+
+	return sf::Color(pixel[0], pixel[1], pixel[2], pixel[3]);
+}
+
+void SoftwareRasterizer::CopyPixels(std::vector<sf::Uint8>& pixels) const
+{
+	pixels.resize(m_Pixels.size());
+
+	for (unsigned x = 0; x < m_Width; x++) {
+		const sf::Uint8* column = m_Pixels.data() + (x * m_Height * 4);
+
+		for (unsigned y = 0; y < m_Height; y++) {
+			std::copy(column + (y * 4), column + (y * 4) + 4, pixels.data() + (((y * m_Width) + x) * 4));
+		}
+	}
+}
+
+}
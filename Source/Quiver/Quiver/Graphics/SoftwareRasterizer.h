@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+
+#include <SFML/Config.hpp>
+#include <SFML/Graphics/Color.hpp>
+
+#include "Quiver/Graphics/Fog.h"
+#include "Quiver/Graphics/Light.h"
+
+namespace qvr {
+
+struct RaycastColumn;
+
+// A view of some RGBA pixels to sample RaycastColumns from.
+// A texture with no pixels samples as white, like ColumnDrawer's default texture.
+struct SoftwareTexture {
+	const sf::Uint8* m_Pixels = nullptr;
+	unsigned m_Width = 0;
+	unsigned m_Height = 0;
+};
+
+// The lighting that WorldRaycastRenderer's shader applies to columns.
+struct SoftwareLighting {
+	AmbientLight m_Ambient;
+	DirectionalLight m_Directional;
+	Fog m_Fog;
+};
+
+// Draws RaycastColumns into an RGBA framebuffer on the CPU, with the same
+// lighting, fog and blending as WorldRaycastRenderer's shader.
+// Needs no graphics driver, so it also suits headless tests and benchmarks.
+class SoftwareRasterizer {
+public:
+	// Also clears the framebuffer.
+	void SetSize(const unsigned width, const unsigned height);
+
+	unsigned GetWidth() const { return m_Width; }
+	unsigned GetHeight() const { return m_Height; }
+
+	// Makes every pixel transparent.
+	void Clear();
+
+	void Draw(const RaycastColumn& column, const SoftwareTexture& texture, const SoftwareLighting& lighting);
+
+	// Pixels are stored with premultiplied alpha, so the framebuffer can be composited
+	// over whatever was drawn before it with sf::BlendMode(One, OneMinusSrcAlpha).
+	sf::Color GetPixel(const unsigned x, const unsigned y) const;
+
+	// Writes the framebuffer out row by row, ready for sf::Texture::update.
+	void CopyPixels(std::vector<sf::Uint8>& pixels) const;
+
+	// SSE2 is used if it was available at compile time. Turning it off is for comparing against.
+	static bool IsSimdAvailable();
+	void SetUseSimd(const bool useSimd) { m_UseSimd = useSimd && IsSimdAvailable(); }
+	bool GetUseSimd() const { return m_UseSimd; }
+
+private:
+	unsigned m_Width = 0;
+	unsigned m_Height = 0;
+
+	// Stored column by column, because that's the order it's drawn in.
+	std::vector<sf::Uint8> m_Pixels;
+
+	bool m_UseSimd = IsSimdAvailable();
+};
+
+}
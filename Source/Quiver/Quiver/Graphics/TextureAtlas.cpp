@@ -0,0 +1,115 @@
+#include "TextureAtlas.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
+namespace qvr {
+
+ShelfPacker::ShelfPacker(const sf::Vector2u& size, const unsigned padding)
+	: mSize(size)
+	, mPadding(padding)
+{}
+
+bool ShelfPacker::Pack(const sf::Vector2u& size, sf::Vector2u& position)
+{
+	const unsigned paddedWidth = size.x + (mPadding * 2);
+	const unsigned paddedHeight = size.y + (mPadding * 2);
+
+	if (paddedWidth > mSize.x || paddedHeight > mSize.y) return false;
+
+	// Use the shortest shelf it fits on, to waste as little height as possible.
+	Shelf* bestShelf = nullptr;
+
+	for (Shelf& shelf : mShelves) {
+		if (shelf.mHeight < paddedHeight) continue;
+		if (mSize.x - shelf.mUsedWidth < paddedWidth) continue;
+
+		if (!bestShelf || shelf.mHeight < bestShelf->mHeight) {
+			bestShelf = &shelf;
+		}
+	}
+
+	if (!bestShelf) {
+		if (mSize.y - mUsedHeight < paddedHeight) return false;
+
+		mShelves.push_back(Shelf{ mUsedHeight, paddedHeight, 0 });
+		mUsedHeight += paddedHeight;
+
+		bestShelf = &mShelves.back();
+	}
+
+	position.x = bestShelf->mUsedWidth + mPadding;
+	position.y = bestShelf->mTop + mPadding;
+
+	bestShelf->mUsedWidth += paddedWidth;
+
+	return true;
+}
+
+namespace {
+
+// A copy of image with its edge pixels repeated padding times around it.
+sf::Image Extrude(const sf::Image& image, const unsigned padding)
+{
+	const sf::Vector2u size = image.getSize();
+
+	sf::Image padded;
+	padded.create(size.x + (padding * 2), size.y + (padding * 2));
+
+	for (unsigned y = 0; y < padded.getSize().y; y++) {
+		const unsigned sourceY = std::min(std::max((int)y - (int)padding, 0), (int)size.y - 1);
+
+		for (unsigned x = 0; x < padded.getSize().x; x++) {
+			const unsigned sourceX = std::min(std::max((int)x - (int)padding, 0), (int)size.x - 1);
+
+			padded.setPixel(x, y, image.getPixel(sourceX, sourceY));
+		}
+	}
+
+	return padded;
+}
+
+}
+
+TextureRegion TextureAtlas::Add(const sf::Image& image)
+{
+	const sf::Vector2u size = image.getSize();
+
+	if (size.x == 0 || size.y == 0) return TextureRegion();
+	if (size.x > MaxTextureSize || size.y > MaxTextureSize) return TextureRegion();
+
+	sf::Vector2u position;
+
+	Page* page = nullptr;
+
+	for (Page& existingPage : mPages) {
+		if (existingPage.mPacker.Pack(size, position)) {
+			page = &existingPage;
+			break;
+		}
+	}
+
+	if (!page) {
+		auto texture = std::make_shared<sf::Texture>();
+
+		if (!texture->create(PageSize, PageSize)) return TextureRegion();
+
+		mPages.push_back(Page{ texture, ShelfPacker(sf::Vector2u(PageSize, PageSize), Padding) });
+
+		page = &mPages.back();
+
+		const bool packed = page->mPacker.Pack(size, position);
+		assert(packed);
+	}
+
+	page->mTexture->update(Extrude(image, Padding), position.x - Padding, position.y - Padding);
+
+	mRevision++;
+
+	return TextureRegion{ page->mTexture, sf::Vector2i(position) };
+}
+
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+
+namespace sf {
+class Image;
+class Texture;
+}
+
+namespace qvr {
+
+// Packs rectangles into a fixed-size area, left to right along horizontal shelves.
+// Nothing is ever removed.
+class ShelfPacker
+{
+public:
+	ShelfPacker(const sf::Vector2u& size, const unsigned padding);
+
+	// Finds space for a rectangle with padding on every side.
+	// Returns false if there isn't room. position excludes the padding.
+	bool Pack(const sf::Vector2u& size, sf::Vector2u& position);
+
+	const sf::Vector2u& GetSize() const { return mSize; }
+
+private:
+	struct Shelf {
+		unsigned mTop;
+		unsigned mHeight;
+		unsigned mUsedWidth;
+	};
+
+	sf::Vector2u mSize;
+	unsigned mPadding;
+
+	std::vector<Shelf> mShelves;
+	unsigned mUsedHeight = 0;
+};
+
+// Where a texture was copied to in a TextureAtlas page.
+struct TextureRegion
+{
+	// Null if the texture isn't in an atlas.
+	std::shared_ptr<sf::Texture> mPage;
+
+	sf::Vector2i mOffset;
+};
+
+// Copies small textures into a few large ones, so that things textured
+// with different ones can be drawn without rebinding in between.
+class TextureAtlas
+{
+public:
+	static const unsigned PageSize = 1024;
+
+	// Anything wider or taller than this is left out.
+	static const unsigned MaxTextureSize = 256;
+
+	// Each texture's edge pixels are repeated this many times around it,
+	// so that sampling near the edge never picks up a neighbour.
+	static const unsigned Padding = 1;
+
+	// Returns a region with no page if the image is too big.
+	TextureRegion Add(const sf::Image& image);
+
+	unsigned GetPageCount() const { return mPages.size(); }
+
+	const sf::Texture& GetPage(const unsigned index) const { return *mPages[index].mTexture; }
+
+	// Incremented whenever any page's pixels change.
+	unsigned GetRevision() const { return mRevision; }
+
+private:
+	struct Page {
+		std::shared_ptr<sf::Texture> mTexture;
+		ShelfPacker mPacker;
+	};
+
+	std::vector<Page> mPages;
+
+	unsigned mRevision = 0;
+};
+
+}
@@ -4,6 +4,7 @@
 
 #include <ImGui/imgui.h>
 #include <ImGui/imgui-SFML.h>
+#include <SFML/Graphics/Image.hpp>
 #include <SFML/Graphics/Texture.hpp>
 #include <spdlog/spdlog.h>
 
@@ -11,13 +12,10 @@
 
 namespace qvr {
 
-std::shared_ptr<sf::Texture> TextureLibrary::LoadTexture(std::string filename)
-{
-	const char* logCtx = "TextureLibrary::LoadTexture";
-	auto log = spdlog::get("console");
-	assert(log);
+namespace {
 
-	// Need to cast filename to all-lower case.
+void ToLower(std::string& filename)
+{
 	std::transform(
 		filename.begin(),
 		filename.end(),
@@ -26,6 +24,18 @@ std::shared_ptr<sf::Texture> TextureLibrary::LoadTexture(std::string filename)
 	{
 		return static_cast<char>(std::tolower(static_cast<int>(c)));
 	});
+}
+
+}
+
+std::shared_ptr<sf::Texture> TextureLibrary::LoadTexture(std::string filename)
+{
+	const char* logCtx = "TextureLibrary::LoadTexture";
+	auto log = spdlog::get("console");
+	assert(log);
+
+	// Need to cast filename to all-lower case.
+	ToLower(filename);
 
 	// Check if there's already a copy of it in memory.
 	if (mLoadedTextures.find(filename) != mLoadedTextures.end())
@@ -51,15 +61,21 @@ std::shared_ptr<sf::Texture> TextureLibrary::LoadTexture(std::string filename)
 	}
 
 	// Need to try loading.
+	sf::Image image;
 	auto texture = std::make_shared<sf::Texture>();
 
-	if (texture->loadFromFile(filename)) {
+	if (image.loadFromFile(filename) && texture->loadFromImage(image)) {
 		log->debug(
 			"{}: {} was loaded successfully.",
 			logCtx,
 			filename.c_str());
 		// Keep track of it.
 		mLoadedTextures[filename] = texture;
+
+		if (mAtlasRegions.find(filename) == mAtlasRegions.end()) {
+			mAtlasRegions[filename] = mAtlas.Add(image);
+		}
+
 		return texture;
 	}
 
@@ -68,6 +84,17 @@ std::shared_ptr<sf::Texture> TextureLibrary::LoadTexture(std::string filename)
 	return nullptr;
 }
 
+TextureRegion TextureLibrary::GetAtlasRegion(std::string filename) const
+{
+	ToLower(filename);
+
+	const auto it = mAtlasRegions.find(filename);
+
+	if (it == mAtlasRegions.end()) return TextureRegion();
+
+	return it->second;
+}
+
 void TextureLibraryGui::ProcessGui() {
 	using namespace std;
 
@@ -77,6 +104,8 @@ void TextureLibraryGui::ProcessGui() {
 		return;
 	}
 
+	ImGui::Text("Atlas Pages: %u", mTextureLibrary.GetAtlas().GetPageCount());
+
 	vector<string> textureNames;
 	for (const auto& kvp : mTextureLibrary.mLoadedTextures) {
 		textureNames.push_back(kvp.first);
@@ -104,6 +133,15 @@ void TextureLibraryGui::ProcessGui() {
 
 		ImGui::Text("Loaded: %s", tex.expired() ? "False" : "True");
 
+		const TextureRegion region = mTextureLibrary.GetAtlasRegion(mCurrentTextureName);
+
+		if (region.mPage) {
+			ImGui::Text("Atlas Offset: %d, %d", region.mOffset.x, region.mOffset.y);
+		}
+		else {
+			ImGui::Text("Not in the atlas");
+		}
+
 		if (!tex.expired()) {
 			const auto loadedTex = tex.lock();
 			ImGui::Image(*loadedTex);
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <unordered_map>
 
+#include "Quiver/Graphics/TextureAtlas.h"
+
 namespace sf {
 	class Texture;
 }
@@ -13,9 +16,21 @@ class TextureLibrary
 {
 public:
 	std::shared_ptr<sf::Texture> LoadTexture(std::string filename);
+
+	// Where a copy of the texture was packed into an atlas page when it was loaded.
+	// The region has no page if the texture was too big, or hasn't been loaded.
+	TextureRegion GetAtlasRegion(std::string filename) const;
+
+	const TextureAtlas& GetAtlas() const { return mAtlas; }
+
 private:
 	std::unordered_map<std::string, std::weak_ptr<sf::Texture>> mLoadedTextures;
 
+	// Textures keep their regions after being unloaded, so reloading doesn't use up more space.
+	std::unordered_map<std::string, TextureRegion> mAtlasRegions;
+
+	TextureAtlas mAtlas;
+
 	friend class TextureLibraryGui;
 };
 
@@ -1,6 +1,8 @@
 #pragma once
 
-#include <array>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
 
 #include <gsl/span>
 
@@ -8,9 +10,16 @@
 
 namespace qvr {
 
+// The rects to draw something with, one for each angle it can be seen from.
+// Animated views point into the AnimationLibrary, so changing frames doesn't
+// copy anything. A single static view is kept here.
 struct ViewBuffer {
 	int viewCount = 0;
-	std::array<Animation::Rect, 8> views;
+
+	// Null if the view is staticView.
+	const Animation::Rect* views = nullptr;
+
+	Animation::Rect staticView;
 
 	// TODO: Consider making initial value of viewCount == 1.
 	// TODO: Consider making viewCount < 1 illegal.
@@ -24,31 +33,43 @@ inline void SetView(
 	const Animation::Rect& singleView)
 {
 	vb.viewCount = 1;
-	vb.views[0] = singleView;
+	vb.views = nullptr;
+	vb.staticView = singleView;
 }
 
+// Doesn't copy newViews, so they have to stay where they are until the
+// views change again or KeepFirstView is called.
 inline void SetViews(
 	ViewBuffer& target,
 	const gsl::span<const Animation::Rect> newViews)
 {
-	target.viewCount =
-		std::min(
-		(int)newViews.length(),
-			(int)target.views.max_size());
-
-	std::copy(
-		std::begin(newViews),
-		std::begin(newViews) + target.viewCount,
-		std::begin(target.views));
+	target.viewCount = (int)newViews.length();
+	target.views = newViews.data();
 }
 
 inline auto GetViews(const ViewBuffer& vb) -> gsl::span<const Animation::Rect> {
-	return gsl::make_span(&vb.views[0], vb.viewCount);
+	return gsl::make_span(vb.views ? vb.views : &vb.staticView, vb.viewCount);
+}
+
+// The first view, or an empty rect if there aren't any.
+inline const Animation::Rect& GetView(const ViewBuffer& vb) {
+	return (vb.views && vb.viewCount > 0) ? vb.views[0] : vb.staticView;
+}
+
+// Copies the first view into staticView, for when the views vb points at are
+// about to go away. Any others are dropped, so it looks the same from every angle.
+inline void KeepFirstView(ViewBuffer& vb)
+{
+	if (!vb.views) return;
+
+	vb.staticView = GetView(vb);
+	vb.viewCount = std::min(vb.viewCount, 1);
+	vb.views = nullptr;
 }
 
 inline const Animation::Rect& CalculateView(
-	const ViewBuffer& vb, 
-	const float objectAngle, 
+	const ViewBuffer& vb,
+	const float objectAngle,
 	const float viewAngle)
 {
 	assert(vb.viewCount > 0);
@@ -62,7 +83,7 @@ inline const Animation::Rect& CalculateView(
 	assert(viewIndex >= 0);
 	assert(viewIndex < vb.viewCount);
 
-	return vb.views[viewIndex];
+	return GetViews(vb)[viewIndex];
 }
 
-}
\ No newline at end of file
+}
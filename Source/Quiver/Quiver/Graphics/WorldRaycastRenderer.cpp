@@ -1,24 +1,50 @@
 #include "WorldRaycastRenderer.h"
 
-#include <array>
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include <SFML/OpenGL.hpp>
 #include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Image.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Shader.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/Texture.hpp>
 #include <SFML/System/Vector2.hpp>
 
+#include <Box2D/Collision/b2BroadPhase.h>
+#include <Box2D/Collision/Shapes/b2ChainShape.h>
+#include <Box2D/Collision/Shapes/b2CircleShape.h>
+#include <Box2D/Collision/Shapes/b2EdgeShape.h>
+#include <Box2D/Collision/Shapes/b2PolygonShape.h>
 #include <Box2D/Common/b2Math.h>
+#include <Box2D/Dynamics/b2Body.h>
 #include <Box2D/Dynamics/b2Fixture.h>
 #include <Box2D/Dynamics/b2World.h>
 #include <Box2D/Dynamics/b2WorldCallbacks.h>
 
+#include <ImGui/imgui.h>
+
 #include <spdlog/spdlog.h>
 
+#include "Quiver/Entity/PhysicsComponent/PhysicsComponent.h"
 #include "Quiver/Graphics/Camera3D.h"
 #include "Quiver/Graphics/FixtureRenderData.h"
+#include "Quiver/Graphics/Fog.h"
+#include "Quiver/Graphics/Light.h"
+#include "Quiver/Graphics/RaycastColumn.h"
+#include "Quiver/Graphics/RaycastDepthBuffer.h"
+#include "Quiver/Graphics/RenderResources.h"
 #include "Quiver/Graphics/RenderSettings.h"
+#include "Quiver/Graphics/SoftwareRasterizer.h"
+#include "Quiver/Graphics/TextureLibrary.h"
+#include "Quiver/Misc/ThreadPool.h"
 #include "Quiver/World/World.h"
 
 namespace {
@@ -122,27 +148,33 @@ void glCheckError(const char* file, unsigned int line, const char* expression)
 
 #endif
 
-inline sf::Vector2f B2VecToSFVec(const b2Vec2& b2vec) {
-	return sf::Vector2f(b2vec.x, b2vec.y);
-}
-
 }
 
 namespace qvr {
 
 class WorldRaycastRendererImpl {
+	struct RayIntersection
+	{
+		b2Fixture* m_fixture;
+		b2Vec2 m_point;
+		b2Vec2 m_normal;
+		float32 m_fraction;
+		// Index into m_RaycastCallbacks, which isn't the same as the x coordinate if there are several views.
+		int m_screenX;
+		// Index into the Snapshot's m_Candidates, or -1 if the fixture wasn't found through frustum culling.
+		int m_Candidate;
+	};
+
+	// Intersections are bump-allocated from one of these per thread. A column is
+	// cast start-to-finish on one thread, so its intersections are contiguous.
+	// Cleared every frame, but keeps its capacity.
+	using HitArena = std::vector<RayIntersection>;
+
+	std::vector<HitArena> m_HitArenas;
+
 	class RaycastCallback : public b2RayCastCallback
 	{
 	public:
-		struct RayIntersection
-		{
-			b2Fixture* m_fixture;
-			b2Vec2 m_point;
-			b2Vec2 m_normal;
-			float32 m_fraction;
-			int m_screenX;
-		};
-
 		float32 ReportFixture(
 			b2Fixture* fixture,
 			const b2Vec2& point,
@@ -150,423 +182,1714 @@ class WorldRaycastRendererImpl {
 			float32 fraction)
 			override;
 
-		static const unsigned sm_MaxNumIntersections = 32;
+		// Same contract as ReportFixture, but doesn't look at the fixture, 
+		// so it's safe to call when the fixture might not exist anymore.
+		float32 ReportIntersection(
+			b2Fixture* fixture,
+			const b2Vec2& point,
+			const b2Vec2& normal,
+			float32 fraction,
+			const bool opaque);
+
+		// Points this column's intersections at the end of the given arena.
+		void Begin(HitArena& arena);
 
-		std::array<RayIntersection, sm_MaxNumIntersections> m_Intersections;
+		const RayIntersection* begin() const { return m_Arena->data() + m_FirstIntersection; }
+		const RayIntersection* end() const { return begin() + m_IntersectionCount; }
 
+		HitArena* m_Arena = nullptr;
+		unsigned m_FirstIntersection = 0;
 		unsigned m_IntersectionCount = 0;
 		unsigned m_Index = 0;
+
+		// Set while reporting a fixture from the Snapshot's m_Candidates.
+		int m_ReportingCandidate = -1;
+
+		// The fraction of the nearest opaque intersection. Anything further away is hidden.
+		float32 m_OpaqueFraction = 1.0f;
+
+		// Drops the intersections that ended up behind the nearest opaque one.
+		void RemoveHiddenIntersections();
+
+		// Orders this column's intersections so that further away ones come first.
+		void SortFarthestFirst();
 	};
 
 	std::vector<RaycastCallback> m_RaycastCallbacks;
 
-	std::vector<RaycastCallback::RayIntersection> m_AllIntersections;
-
-	struct Column {
-		float m_Top;
-		float m_Bottom;
-		float m_X;
-		float m_Distance;
-		float m_U;
-		float m_VTop;
-		float m_VBottom;
-		sf::Color m_BlendColor;
-		sf::Vector2f m_Normal;
-		const sf::Texture* m_Texture;
+	// A camera, the part of the target it's drawn into, and everything about it that its rays need.
+	struct View {
+		// A copy, since the original might have moved on by the time the rays are cast.
+		Camera3D m_Camera;
+		sf::IntRect m_Viewport;
+		b2Vec2 m_Position;
+		b2Vec2 m_Forwards;
+		// The camera's right-vector, stretched/squashed a bit.
+		b2Vec2 m_ViewPlane;
+		float m_ScreenXDelta;
+		// This view's columns start here in m_RaycastCallbacks. There are m_Viewport.width of them.
+		unsigned m_FirstColumn;
+		// This view's candidates are [m_FirstCandidate, m_EndCandidate) in the Snapshot's m_Candidates.
+		unsigned m_FirstCandidate;
+		unsigned m_EndCandidate;
+	};
+
+	// A fixture that overlaps a view, along with the range of
+	// columns whose rays might hit it.
+	struct Candidate {
+		b2Fixture* m_Fixture;
+		int32 m_ChildIndex;
+		int m_FirstColumn;
+		int m_LastColumn;
+		unsigned m_View;
+		// A detached sprite. It's intersected as if it lay flat across the view, 
+		// whatever its fixture's rotation, so that every view sees it face on.
+		bool m_Billboard;
+		b2Vec2 m_SpritePosition;
+		float m_SpriteRadius;
+		// Where the fixture's body is drawn, which is somewhere between its last two steps.
+		b2Transform m_Transform;
+		// The fixture's shape (or the edge of its chain) is copied into the Snapshot's 
+		// array for this type, at this index. m_Fixture is only kept to tell fixtures apart.
+		b2Shape::Type m_ShapeType;
+		unsigned m_ShapeIndex;
+	};
+
+	// Everything about a World that a frame's rays need, copied out of it so that they can
+	// be cast on the render thread while the World takes its next step. There are two, so 
+	// that one can be filled while the other is cast. They keep their capacity between frames.
+	struct Snapshot {
+		std::vector<View> m_Views;
+
+		// Which view each of m_RaycastCallbacks belongs to.
+		std::vector<unsigned> m_ColumnViews;
+
+		std::vector<Candidate> m_Candidates;
+
+		// Worked out once per candidate per frame rather than once per column.
+		std::vector<FixtureColumnInfo> m_CandidateInfos;
+
+		std::vector<b2PolygonShape> m_Polygons;
+		std::vector<b2CircleShape> m_Circles;
+		std::vector<b2EdgeShape> m_Edges;
+
+		RenderSettings m_Settings;
+
+		AmbientLight m_AmbientLight;
+		DirectionalLight m_DirectionalLight;
+		Fog m_Fog;
+
+		unsigned m_AtlasRevision = 0;
+
+		// Only set if the frame is cast straight away, on the World's own thread.
+		// Without frustum culling, the rays are cast against its b2World directly.
+		const World* m_World = nullptr;
 	};
 
+	Snapshot m_Snapshots[2];
+
+	// Frames are captured into this one, and cast from the other one.
+	unsigned m_CaptureSnapshot = 0;
+
+	// Copies the views, lighting and candidates out of the World into m_Snapshots[m_CaptureSnapshot].
+	void Capture(
+		const World& world, 
+		const std::vector<RaycastRenderView>& views, 
+		const RenderSettings& settings,
+		const bool pipelined);
+
+	// Fills the snapshot's candidates from the broad-phase, once per frame, so that each
+	// ray only has to be tested against the handful of fixtures it could hit.
+	// The broad-phase is only queried once, however many views there are.
+	void GatherCandidates(
+		const b2World& world,
+		const float interpolation,
+		Snapshot& snapshot);
+
+	// The candidate's copy of its fixture's shape.
+	static const b2Shape& GetShape(const Snapshot& snapshot, const Candidate& candidate);
+
+	// Casts the snapshot's rays and turns what they hit into m_AllColumns. Doesn't touch 
+	// the World unless the snapshot was captured without pipelining.
+	void Cast(const Snapshot& snapshot);
+
+	// Submits m_AllColumns to the target.
+	void Draw(const Snapshot& snapshot, sf::RenderTarget& target);
+
+	using Column = RaycastColumn;
+
 	std::vector<Column> m_AllColumns;
 
-	sf::Shader mShader;
+	// Where a screen column's Columns are in m_PreparedColumns. They're ordered back-to-front.
+	struct ColumnRange {
+		unsigned m_Begin = 0;
+		unsigned m_Count = 0;
+	};
+
+	// This frame's and last frame's Columns, grouped by screen column.
+	std::vector<ColumnRange> m_ColumnRanges;
+	std::vector<ColumnRange> m_PreviousColumnRanges;
+	std::vector<Column> m_PreparedColumns;
+	std::vector<Column> m_PreviousPreparedColumns;
+
+	// Everything about a candidate that affects how its columns look.
+	// If it's the same as last frame, and so is the view, the columns will be too.
+	struct CandidateSignature {
+		const b2Fixture* m_Fixture;
+		int32 m_ChildIndex;
+		int m_FirstColumn;
+		int m_LastColumn;
+		b2Transform m_Transform;
+		FixtureColumnInfo m_Info;
+	};
+
+	std::vector<CandidateSignature> m_Signatures;
+	std::vector<CandidateSignature> m_PreviousSignatures;
+
+	// Everything about the camera and target that affects every column.
+	struct ViewSignature {
+		b2Transform m_CameraTransform;
+		float m_CameraHeightOffset;
+		float m_CameraPitch;
+		float m_CameraFov;
+		float m_RayLength;
+		sf::IntRect m_Viewport;
+	};
+
+	ViewSignature m_PreviousView;
+	bool m_HasPreviousFrame = false;
+
+	// Screen columns whose rays have to be cast this frame. Everything else is reused.
+	std::vector<char> m_DirtyColumns;
+
+	// Compares the view and candidates with last frame's to find out which
+	// screen columns could look any different. Only done when there's a single view.
+	void MarkDirtyColumns(const Snapshot& snapshot);
+
+	// Columns only ever overlap themselves, so any order that draws each screen column 
+	// back-to-front gives the same picture. m_AllColumns is built one 'layer' at a time 
+	// (every column's furthest intersection, then every column's second furthest...)
+	// and each layer is then grouped by texture so that ColumnDrawer can batch them.
+	void GroupLayerByTexture(const unsigned layerBegin, const unsigned layerEnd);
+
+	// Where each layer ends in m_AllColumns.
+	std::vector<unsigned> m_LayerEnds;
+
+	// Scratch space for GroupLayerByTexture.
+	std::vector<Column> m_LayerColumns;
+	std::vector<const sf::Texture*> m_LayerTextures;
+	std::vector<unsigned> m_LayerTextureIndices;
+	std::vector<unsigned> m_LayerTextureOffsets;
+
+	struct Vertex {
+		sf::Vector3f position;
+		sf::Vector2f normal;
+		sf::Vector2f texCoords;
+		sf::Color color;
+	};
+
+	// Turns Columns into GL_LINES. Consecutive Columns that share a texture are 
+	// queued up and submitted with a single draw call.
+	class ColumnDrawer {
+	public:
+		ColumnDrawer(
+			sf::RenderTarget& target, 
+			RenderResources& resources, 
+			const Snapshot& snapshot,
+			std::vector<Vertex>& vertices,
+			RaycastRenderStats& stats);
+
+		~ColumnDrawer();
+
+		void Draw(const Column& column);
+
+	private:
+		void Flush();
+
+		sf::RenderTarget& m_Target;
+		sf::Shader& m_Shader;
+
+		const bool m_Batch;
+
+		const sf::Texture* m_LastTexture = nullptr;
+
+		// Flat white, like a coffee.
+		const sf::Texture& m_DefaultTexture;
+
+		// Vertices waiting to be drawn with m_LastTexture.
+		std::vector<Vertex>& m_Vertices;
+
+		RaycastRenderStats& m_Stats;
+	};
+
+	// Kept between frames so that it doesn't have to be reallocated.
+	std::vector<Vertex> m_Vertices;
+
+	// The CPU alternative to ColumnDrawer. m_AllColumns is rasterized into an 
+	// sf::Texture that is then composited onto the target with one draw call.
+	void DrawSoftware(const Snapshot& snapshot, sf::RenderTarget& target);
+
+	SoftwareTexture GetSoftwareTexture(const sf::Texture* texture);
+
+	SoftwareRasterizer m_SoftwareRasterizer;
+	std::vector<sf::Uint8> m_SoftwareFramePixels;
+	sf::Texture m_SoftwareFrame;
+
+	// Copies of textures' pixels for the SoftwareRasterizer to sample, made on first use.
+	// If a texture's pixels change, or it's destroyed and another one is created at
+	// the same address with the same size, its copy will be out of date.
+	std::unordered_map<const sf::Texture*, sf::Image> m_TextureImages;
+
+	// Atlas pages are added to after they're created, so the copies are
+	// thrown away whenever that happens.
+	unsigned m_AtlasRevision = 0;
+
+	// The last drawn frame's stats and depth buffers. Cast fills in the other ones, 
+	// and Draw swaps them in, so that the render thread doesn't write to what the 
+	// main thread might be reading.
+	RaycastRenderStats m_Stats;
+	RaycastRenderStats m_CastStats;
+
+	// One per view, in the view's coordinates.
+	std::vector<RaycastDepthBuffer> m_DepthBuffers;
+	std::vector<RaycastDepthBuffer> m_CastDepthBuffers;
+
+	// Each RaycastCallback only writes to its own intersection buffer,
+	// so the rays can be cast from any number of threads at once.
+	ThreadPool m_ThreadPool;
+
+	// Null if the RenderResources are shared with other WorldRaycastRenderers.
+	std::unique_ptr<RenderResources> m_OwnResources;
 
-	void LoadShader();
+	RenderResources& m_Resources;
+
+	// Casts pipelined frames, so that the main thread can get on with the next step.
+	// Only ever touches the Snapshot it's given and the cast results; never the World, 
+	// and never OpenGL. Started the first time it's needed.
+	std::thread m_RenderThread;
+	std::mutex m_RenderMutex;
+	std::condition_variable m_CastStarted;
+	std::condition_variable m_CastFinished;
+	bool m_Casting = false;
+	bool m_QuitRenderThread = false;
+
+	// A pipelined frame has been captured and is waiting for CastFrame.
+	bool m_HasCapturedFrame = false;
+	// A pipelined frame has been (or is being) cast and is waiting to be drawn.
+	bool m_HasCastFrame = false;
+
+	void RenderThreadMain();
+
+	// Blocks until the render thread is idle.
+	void WaitForCast();
 
 public:
 	WorldRaycastRendererImpl()
-	{
-		LoadShader();
-	}
-	void Render(const World& world, const Camera3D& camera, const RenderSettings& settings, sf::RenderTarget& target);
+		: m_OwnResources(std::make_unique<RenderResources>())
+		, m_Resources(*m_OwnResources)
+	{}
+
+	WorldRaycastRendererImpl(RenderResources& resources)
+		: m_Resources(resources)
+	{}
+
+	~WorldRaycastRendererImpl();
+	void Render(
+		const World& world, 
+		const std::vector<RaycastRenderView>& views, 
+		const RenderSettings& settings, 
+		sf::RenderTarget& target);
+
+	void CaptureFrame(
+		const World& world,
+		const std::vector<RaycastRenderView>& views,
+		const RenderSettings& settings);
+
+	bool WaitForCastFrame();
+
+	void DrawCastFrame(sf::RenderTarget& target);
+
+	void CastFrame();
+
+	void DiscardFrames();
+
+	const Camera3D& GetCastCamera(const unsigned view) const;
+
+	const RaycastRenderStats& GetStats() const { return m_Stats; }
+
+	const RaycastDepthBuffer& GetDepthBuffer(const unsigned view) const { return m_DepthBuffers[view]; }
 };
 
-void WorldRaycastRendererImpl::Render(const World & world, const Camera3D & camera, const RenderSettings& settings, sf::RenderTarget & target)
+namespace {
+
+// Intersects a ray with a detached sprite as if it lay flat across a view with the
+// given forwards vector. Same contract as b2Fixture::RayCast.
+bool RaycastBillboard(
+	const b2Vec2& spritePosition,
+	const float spriteRadius,
+	const b2Vec2& forwards,
+	const b2RayCastInput& input,
+	b2RayCastOutput& output)
 {
-	assert(world.GetPhysicsWorld());
+	const b2Vec2 direction = input.p2 - input.p1;
+	const float denominator = b2Dot(direction, forwards);
 
-	const auto targetWidth = target.getSize().x;
+	if (denominator <= b2_epsilon) return false;
 
-	if (m_RaycastCallbacks.size() != targetWidth)
-	{
-		m_RaycastCallbacks.resize(targetWidth);
+	const float32 fraction = b2Dot(spritePosition - input.p1, forwards) / denominator;
 
-		m_AllIntersections.reserve(targetWidth * RaycastCallback::sm_MaxNumIntersections);
+	if (fraction < 0.0f || fraction > input.maxFraction) return false;
 
-		m_AllColumns.reserve(m_AllIntersections.size());
+	const b2Vec2 point = input.p1 + fraction * direction;
+	const b2Vec2 right(-forwards.y, forwards.x);
+
+	if (std::abs(b2Dot(point - spritePosition, right)) > spriteRadius) {
+		return false;
 	}
 
-	m_AllIntersections.resize(0);
-	m_AllColumns.resize(0);
+	output.fraction = fraction;
+	output.normal = -forwards;
 
-	// This is a bit grim.
-	for (unsigned i = 0; i < m_RaycastCallbacks.size(); ++i)
-	{
-		m_RaycastCallbacks[i].m_Index = i;
-		m_RaycastCallbacks[i].m_IntersectionCount = 0;
+	return true;
+}
+
+// A FixtureColumnInfo for a view drawn into the given viewport, in the target's coordinates.
+FixtureColumnInfo CalculateViewInfo(
+	const FixtureRenderData& renderData,
+	const Camera3D& camera,
+	const sf::IntRect& viewport,
+	const bool useTextureAtlas)
+{
+	FixtureColumnInfo info =
+		CalculateFixtureColumnInfo(
+			renderData,
+			camera,
+			sf::Vector2u(viewport.width, viewport.height),
+			useTextureAtlas);
+
+	info.m_Horizon += viewport.top;
+
+	return info;
+}
+
+// Cuts off the parts of a column that are above top or below bottom.
+void ClipColumn(RaycastColumn& column, const float top, const float bottom)
+{
+	const float height = column.m_Bottom - column.m_Top;
+
+	if (height <= 0.0f) return;
+
+	const float texelsPerPixel = (column.m_VBottom - column.m_VTop) / height;
+
+	if (column.m_Top < top) {
+		column.m_VTop += (top - column.m_Top) * texelsPerPixel;
+		column.m_Top = top;
 	}
 
-	auto DoRaycast = [&](RaycastCallback& cb)
-	{
-		const b2World& physicsWorld = *world.GetPhysicsWorld();
+	if (column.m_Bottom > bottom) {
+		column.m_VBottom -= (column.m_Bottom - bottom) * texelsPerPixel;
+		column.m_Bottom = bottom;
+	}
 
-		const auto cameraPosition = camera.GetPosition();
-		const auto cameraForwards = camera.GetForwards();
-		const float screenXDelta = 2.0f / (float)targetWidth;
+	if (column.m_Bottom < column.m_Top) {
+		column.m_Bottom = column.m_Top;
+	}
+}
 
-		const float viewPlaneWidthModifier = camera.GetViewPlaneWidthModifier();
-		// The 'view plane' vector is the camera's right-vector, stretched/squashed a bit:
-		const b2Vec2 viewPlane(
-			cameraForwards.y * viewPlaneWidthModifier * (-1),
-			cameraForwards.x * viewPlaneWidthModifier);
+}
 
-		// Cheeky wee lambda to calculate the end point of the ray.
-		const auto rayEnd = [&]()
-		{
-			const auto screenX = -1.0f + screenXDelta * cb.m_Index;
-			auto rayDir = (cameraForwards + (screenX * viewPlane));
-			rayDir.Normalize();
-			return cameraPosition + (settings.m_RayLength * rayDir);
-		}();
+void WorldRaycastRendererImpl::Capture(
+	const World & world,
+	const std::vector<RaycastRenderView>& views,
+	const RenderSettings& settings,
+	const bool pipelined)
+{
+	assert(world.GetPhysicsWorld());
 
-		physicsWorld.RayCast(&cb, cameraPosition, rayEnd);
-	};
+	Snapshot& snapshot = m_Snapshots[m_CaptureSnapshot];
 
-	std::for_each(
-		m_RaycastCallbacks.begin(),
-		m_RaycastCallbacks.end(),
-		DoRaycast);
+	snapshot.m_Views.clear();
+	snapshot.m_ColumnViews.clear();
 
-	// shove all intersections into one big array
-	for (const auto& raycastCallback : m_RaycastCallbacks)
+	for (const RaycastRenderView& renderView : views)
 	{
-		const auto begin = std::begin(raycastCallback.m_Intersections);
-		const auto end = begin + raycastCallback.m_IntersectionCount;
+		assert(renderView.m_Camera);
+
+		View view{ *renderView.m_Camera };
+		view.m_Viewport = renderView.m_Viewport;
+		view.m_Position = view.m_Camera.GetPosition();
+		view.m_Forwards = view.m_Camera.GetForwards();
+
+		const float viewPlaneWidthModifier = view.m_Camera.GetViewPlaneWidthModifier();
+		view.m_ViewPlane = b2Vec2(
+			view.m_Forwards.y * viewPlaneWidthModifier * (-1),
+			view.m_Forwards.x * viewPlaneWidthModifier);
+
+		view.m_ScreenXDelta = 2.0f / (float)view.m_Viewport.width;
+		view.m_FirstColumn = snapshot.m_ColumnViews.size();
+		view.m_FirstCandidate = 0;
+		view.m_EndCandidate = 0;
+
+		snapshot.m_ColumnViews.insert(
+			snapshot.m_ColumnViews.end(), 
+			view.m_Viewport.width, 
+			snapshot.m_Views.size());
+
+		snapshot.m_Views.push_back(view);
+	}
+
+	snapshot.m_Settings = settings;
+
+	// Another thread can't cast rays against the b2World, so it has to have candidates.
+	// Detached sprites are only turned to face the first view's camera in the b2World, so
+	// other views have to have candidates too, which are turned to face each view.
+	if (pipelined || views.size() > 1) {
+		snapshot.m_Settings.m_FrustumCull = true;
+	}
+
+	snapshot.m_World = pipelined ? nullptr : &world;
+
+	snapshot.m_AmbientLight = world.GetAmbientLight();
+	snapshot.m_DirectionalLight = world.GetDirectionalLight();
+	snapshot.m_Fog = world.GetFog();
+	snapshot.m_AtlasRevision = world.GetTextureLibrary().GetAtlas().GetRevision();
+
+	snapshot.m_Candidates.clear();
+	snapshot.m_CandidateInfos.clear();
+	snapshot.m_Polygons.clear();
+	snapshot.m_Circles.clear();
+	snapshot.m_Edges.clear();
 
-		m_AllIntersections.insert(
-			std::end(m_AllIntersections),
-			begin,
-			end);
+	if (!snapshot.m_Settings.m_FrustumCull) return;
+
+	GatherCandidates(*world.GetPhysicsWorld(), world.GetRenderInterpolation(), snapshot);
+
+	snapshot.m_CandidateInfos.resize(snapshot.m_Candidates.size());
+
+	// Lazy Animators only write to the fixtures that get drawn, and not from more than one thread.
+	for (const Candidate& candidate : snapshot.m_Candidates) {
+		world.GetAnimators().UpdateTarget(
+			((const FixtureRenderData*)candidate.m_Fixture->GetUserData())->GetAnimatorTarget());
 	}
-	
-	using RayIntersection = RaycastCallback::RayIntersection;
 
-	// sort by distance such that further away intersections come first
-	std::sort(
-		m_AllIntersections.begin(),
-		m_AllIntersections.end(),
-		[](const RayIntersection& a, const RayIntersection& b)
+	const auto CalculateCandidateInfo = [&snapshot](const int index)
 	{
-		return (a.m_fraction > b.m_fraction);
-	});
+		const Candidate& candidate = snapshot.m_Candidates[index];
+		const View& view = snapshot.m_Views[candidate.m_View];
+
+		snapshot.m_CandidateInfos[index] = CalculateViewInfo(
+			*(const FixtureRenderData*)candidate.m_Fixture->GetUserData(),
+			view.m_Camera,
+			view.m_Viewport,
+			snapshot.m_Settings.m_TextureAtlas);
+	};
 
-	const auto targetSize = target.getSize();
+	// The render thread has the ThreadPool while it's casting.
+	if (m_HasCastFrame) {
+		for (unsigned i = 0; i < snapshot.m_Candidates.size(); i++) {
+			CalculateCandidateInfo(i);
+		}
+	}
+	else {
+		m_ThreadPool.SetThreadCount(std::max(settings.m_ThreadCount, 0));
+		m_ThreadPool.ParallelFor(snapshot.m_Candidates.size(), CalculateCandidateInfo);
+	}
+}
 
-	auto Prepare = [targetSize, &camera](const RayIntersection& intersection) -> Column
+const b2Shape& WorldRaycastRendererImpl::GetShape(const Snapshot& snapshot, const Candidate& candidate)
+{
+	switch (candidate.m_ShapeType)
 	{
-		const auto& renderData =
-			*(qvr::FixtureRenderData*)(intersection.m_fixture->GetUserData());
+	case b2Shape::e_circle:
+		return snapshot.m_Circles[candidate.m_ShapeIndex];
+	case b2Shape::e_edge:
+		return snapshot.m_Edges[candidate.m_ShapeIndex];
+	default:
+		return snapshot.m_Polygons[candidate.m_ShapeIndex];
+	}
+}
 
-		const b2Vec2 displacement = intersection.m_point - camera.GetPosition();
-		const float  distance = b2Dot(displacement, camera.GetForwards());
+void WorldRaycastRendererImpl::Cast(const Snapshot& snapshot)
+{
+	const RenderSettings& settings = snapshot.m_Settings;
 
-		// At a distance of 1 metre, a vertical metre is enough pixels in height to fill the screen.
-		const float oneMetreInPixels = abs(targetSize.y / distance);
+	const unsigned columnCount = snapshot.m_ColumnViews.size();
 
-		const float lineOffset = [&renderData, &camera, oneMetreInPixels]()
-		{
-			const float groundOffset = renderData.GetGroundOffset()    * oneMetreInPixels;
-			const float heightOffset = (renderData.GetHeight() - 1.0f) * oneMetreInPixels;
-			const float cameraHeightOffset = camera.GetHeightOffset() * 2.0f * oneMetreInPixels;
+	if (m_RaycastCallbacks.size() != columnCount)
+	{
+		m_RaycastCallbacks.resize(columnCount);
+	}
 
-			return -groundOffset - heightOffset - cameraHeightOffset;
-		}();
+	m_AllColumns.resize(0);
 
-		const float cameraPitchOffset = (float)GetPitchOffsetInPixels(camera, targetSize.y);
-
-		const float lineHeight = renderData.GetHeight() * oneMetreInPixels;
-		const float lineStartY = ((targetSize.y - lineHeight + lineOffset) / 2) + cameraPitchOffset;
-		const float lineEndY = ((targetSize.y + lineHeight + lineOffset) / 2) + cameraPitchOffset;
-
-		const Animation::Rect textureRect = 
-			renderData.GetViews().viewCount <= 1 ?
-			renderData.GetViews().views[0] :
-			CalculateView(
-				renderData.GetViews(),
-				renderData.GetObjectAngle(),
-				[&camera, &renderData]() {
-					const b2Vec2 disp = renderData.GetSpritePosition() - camera.GetPosition();
-					return b2Atan2(disp.y, disp.x) + b2_pi;
-				}());
-
-		auto CalculateU = [&camera](
-			const b2Vec2& hitPoint,
-			const b2Vec2& flatSpritePos,
-			const float flatSpriteRadius,
-			const Animation::Rect& textureRect)
-		{
-			const b2Vec2 perp(-camera.GetForwards().y, camera.GetForwards().x);
+	// This is a bit grim.
+	for (unsigned i = 0; i < m_RaycastCallbacks.size(); ++i)
+	{
+		m_RaycastCallbacks[i].m_Index = i;
+	}
 
-			const b2Vec2 left = flatSpritePos - (flatSpriteRadius * perp);
+	// Columns from different views would spill into each other without this.
+	const bool clipColumns = snapshot.m_Views.size() > 1;
 
-			float u = (hitPoint - left).Length() / (flatSpriteRadius * 2);
+	m_ThreadPool.SetThreadCount(std::max(settings.m_ThreadCount, 0));
 
-			// Convert to texels.
-			u *= textureRect.right - textureRect.left;
-			u += textureRect.left;
+	auto DoRaycast = [&](RaycastCallback& cb, HitArena& arena)
+	{
+		cb.Begin(arena);
 
-			return u;
-		};
+		const View& view = snapshot.m_Views[snapshot.m_ColumnViews[cb.m_Index]];
 
-		const float u = CalculateU(
-			intersection.m_point,
-			renderData.GetSpritePosition(),
-			renderData.GetSpriteRadius(),
-			textureRect);
-
-		Column output;
-		output.m_BlendColor = renderData.GetColor();
-		output.m_Texture = renderData.GetTexture();
-		output.m_X = (float)intersection.m_screenX;
-		output.m_Top = lineStartY;
-		output.m_Bottom = lineEndY;
-		output.m_Distance = distance;
-		output.m_U = u;
-		output.m_VTop = (float)textureRect.top;
-		output.m_VBottom = (float)textureRect.bottom;
-		output.m_Normal = sf::Vector2f(intersection.m_normal.x, intersection.m_normal.y);
-		return output;
-	};
+		// Cheeky wee lambda to calculate the end point of the ray.
+		const auto rayEnd = [&]()
+		{
+			const auto screenX = -1.0f + view.m_ScreenXDelta * (cb.m_Index - view.m_FirstColumn);
+			auto rayDir = (view.m_Forwards + (screenX * view.m_ViewPlane));
+			rayDir.Normalize();
+			return view.m_Position + (settings.m_RayLength * rayDir);
+		}();
 
-	std::transform(
-		m_AllIntersections.begin(),
-		m_AllIntersections.end(),
-		std::back_inserter(m_AllColumns),
-		Prepare);
+		if (!settings.m_FrustumCull) {
+			assert(snapshot.m_World);
+			snapshot.m_World->GetPhysicsWorld()->RayCast(&cb, view.m_Position, rayEnd);
+			cb.RemoveHiddenIntersections();
+			cb.SortFarthestFirst();
+			return;
+		}
 
-	class ColumnDrawer {
-	public:
-		ColumnDrawer(sf::RenderTarget& target, sf::Shader& shader, const World& world)
-			: m_Target(target)
-			, m_Shader(shader)
+		// Same contract as b2World::RayCast, but only against the fixtures
+		// that can possibly be hit by this column's ray.
+		b2RayCastInput input;
+		input.p1 = view.m_Position;
+		input.p2 = rayEnd;
+		input.maxFraction = 1.0f;
+
+		for (unsigned candidateIndex = view.m_FirstCandidate; candidateIndex < view.m_EndCandidate; candidateIndex++)
 		{
-			m_DefaultTexture.create(1, 1);
-			// Make it white.
+			const Candidate& candidate = snapshot.m_Candidates[candidateIndex];
+
+			if ((int)cb.m_Index < candidate.m_FirstColumn ||
+				(int)cb.m_Index > candidate.m_LastColumn)
 			{
-				auto c = sf::Color::White;
-				m_DefaultTexture.update(&c.r);
+				continue;
 			}
 
-			sf::Shader::bind(&m_Shader);
-			shader.setUniform("ambientLightColor", sf::Glsl::Vec4(world.GetAmbientLight().mColor));
+			b2RayCastOutput output;
 
-			shader.setUniform("directionalLightDirection", B2VecToSFVec(world.GetDirectionalLight().GetDirection()));
-			shader.setUniform("directionalLightColor", sf::Glsl::Vec4(world.GetDirectionalLight().GetColor()));
+			if (candidate.m_Billboard) {
+				if (!RaycastBillboard(
+					candidate.m_SpritePosition, 
+					candidate.m_SpriteRadius, 
+					view.m_Forwards, 
+					input, 
+					output)) 
+				{
+					continue;
+				}
+			}
+			else if (!GetShape(snapshot, candidate).RayCast(&output, input, candidate.m_Transform, 0)) {
+				continue;
+			}
 
-			shader.setUniform("fogColor", sf::Glsl::Vec4(world.GetFog().GetColor()));
-			shader.setUniform("fogMaxIntensity", world.GetFog().GetMaxIntensity());
-			shader.setUniform("fogMaxDistance", world.GetFog().GetMaxDistance());
-			shader.setUniform("fogMinDistance", world.GetFog().GetMinDistance());
+			const float32 fraction = output.fraction;
+			const b2Vec2 point = (1.0f - fraction) * input.p1 + fraction * input.p2;
 
-			sf::Texture::bind(&m_DefaultTexture, sf::Texture::CoordinateType::Pixels);
-			shader.setUniform("texture", sf::Shader::CurrentTexture);
+			cb.m_ReportingCandidate = candidateIndex;
 
-			glCheck(glEnableClientState(GL_VERTEX_ARRAY));
-			glCheck(glEnableClientState(GL_COLOR_ARRAY));
-			glCheck(glEnableClientState(GL_TEXTURE_COORD_ARRAY));
-			glCheck(glEnableClientState(GL_NORMAL_ARRAY));
+			const float32 value = cb.ReportIntersection(
+				candidate.m_Fixture, 
+				point, 
+				output.normal, 
+				fraction, 
+				snapshot.m_CandidateInfos[candidateIndex].m_Opaque);
 
-			glCheck(glVertexPointer(3, GL_FLOAT, sizeof(Vertex), &line[0].position));
-			glCheck(glNormalPointer(GL_FLOAT, sizeof(Vertex), &line[0].normal));
-			glCheck(glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), &line[0].color));
-			glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), &line[0].texCoords));
-		}
+			cb.m_ReportingCandidate = -1;
 
-		void operator()(const Column& column) {
-			if (column.m_Texture != m_LastTexture) {
-				m_LastTexture = column.m_Texture;
+			if (value == 0.0f) break;
 
-				const sf::Texture* textureToBind;
+			if (value > 0.0f) {
+				input.maxFraction = value;
+			}
+		}
 
-				if (column.m_Texture)
-				{
-					textureToBind = column.m_Texture;
-				}
-				else
-				{
-					textureToBind = &m_DefaultTexture;
-				}
+		cb.RemoveHiddenIntersections();
+		cb.SortFarthestFirst();
+	};
 
-				sf::Texture::bind(textureToBind, sf::Texture::CoordinateType::Pixels);
-				m_Shader.setUniform("texture", sf::Shader::CurrentTexture);
-			}
+	m_HitArenas.resize(m_ThreadPool.GetThreadCount());
 
-			line[0].position.x = column.m_X;
-			line[1].position.x = column.m_X;
-			line[0].position.y = column.m_Top;
-			line[1].position.y = column.m_Bottom;
-			line[0].position.z = column.m_Distance;
-			line[1].position.z = column.m_Distance;
+	for (HitArena& arena : m_HitArenas) {
+		arena.clear();
+	}
 
-			line[0].normal = column.m_Normal;
-			line[1].normal = column.m_Normal;
+	MarkDirtyColumns(snapshot);
 
-			line[0].color = column.m_BlendColor;
-			line[1].color = column.m_BlendColor;
+	// Every view's columns are cast in the same job.
+	m_ThreadPool.ParallelForPerThread(
+		m_RaycastCallbacks.size(),
+		[&](const int index, const unsigned threadIndex)
+	{
+		if (m_DirtyColumns[index]) {
+			DoRaycast(m_RaycastCallbacks[index], m_HitArenas[threadIndex]);
+		}
+	});
 
-			line[0].texCoords.x = column.m_U;
-			line[0].texCoords.y = column.m_VTop;
-			line[1].texCoords.x = column.m_U;
-			line[1].texCoords.y = column.m_VBottom;
+	auto Prepare = [this, clipColumns, &snapshot](const RayIntersection& intersection) -> Column
+	{
+		const View& view = snapshot.m_Views[snapshot.m_ColumnViews[intersection.m_screenX]];
 
-			// Draw the line.
-			glCheck(glDrawArrays(GL_LINES, 0, 2));
+		// Candidates' targets were brought up to date when they were captured.
+		if (intersection.m_Candidate < 0) {
+			assert(snapshot.m_World);
+			snapshot.m_World->GetAnimators().UpdateTarget(
+				((const FixtureRenderData*)intersection.m_fixture->GetUserData())->GetAnimatorTarget());
 		}
 
-		~ColumnDrawer()
-		{
-			m_Target.resetGLStates();
+		// Intersections that weren't found through a candidate only happen
+		// without frustum culling, which means the World is still around.
+		const FixtureColumnInfo info =
+			intersection.m_Candidate >= 0 ?
+			snapshot.m_CandidateInfos[intersection.m_Candidate] :
+			CalculateViewInfo(
+				*(qvr::FixtureRenderData*)(intersection.m_fixture->GetUserData()),
+				view.m_Camera,
+				view.m_Viewport,
+				snapshot.m_Settings.m_TextureAtlas);
+
+		Column column = CalculateColumn(
+			info,
+			view.m_Camera,
+			intersection.m_point,
+			intersection.m_normal,
+			view.m_Viewport.left + (intersection.m_screenX - view.m_FirstColumn));
+
+		if (clipColumns) {
+			ClipColumn(
+				column, 
+				(float)view.m_Viewport.top, 
+				(float)(view.m_Viewport.top + view.m_Viewport.height));
 		}
 
-	private:
-		sf::RenderTarget& m_Target;
-		sf::Shader& m_Shader;
+		return column;
+	};
 
-		const sf::Texture* m_LastTexture = nullptr;
+	// Prepare the columns that were cast and carry the rest over from last frame.
+	m_PreparedColumns.clear();
+	m_ColumnRanges.resize(columnCount);
 
-		// Flat white, like a coffee.
-		sf::Texture m_DefaultTexture;
+	unsigned peakColumnIntersections = 0;
+	unsigned recastColumnCount = 0;
 
-		struct Vertex {
-			sf::Vector3f position;
-			sf::Vector2f normal;
-			sf::Vector2f texCoords;
-			sf::Color color;
-		};
+	for (unsigned i = 0; i < columnCount; i++)
+	{
+		ColumnRange& range = m_ColumnRanges[i];
 
-		// Maybe use a custom vertex type in future.
-		Vertex line[2];
-	};
+		range.m_Begin = m_PreparedColumns.size();
 
-	std::for_each(
-		m_AllColumns.begin(),
-		m_AllColumns.end(),
-		ColumnDrawer(target, mShader, world));
-}
+		if (m_DirtyColumns[i])
+		{
+			std::transform(
+				m_RaycastCallbacks[i].begin(),
+				m_RaycastCallbacks[i].end(),
+				std::back_inserter(m_PreparedColumns),
+				Prepare);
 
-float32 WorldRaycastRendererImpl::RaycastCallback::ReportFixture(b2Fixture * fixture, const b2Vec2 & point, const b2Vec2 & normal, float32 fraction)
-{
-	if (fixture->GetUserData() == nullptr)
-	{
-		return 1;
+			recastColumnCount++;
+		}
+		else
+		{
+			const ColumnRange& previousRange = m_PreviousColumnRanges[i];
+
+			m_PreparedColumns.insert(
+				m_PreparedColumns.end(),
+				m_PreviousPreparedColumns.begin() + previousRange.m_Begin,
+				m_PreviousPreparedColumns.begin() + previousRange.m_Begin + previousRange.m_Count);
+		}
+
+		range.m_Count = m_PreparedColumns.size() - range.m_Begin;
+
+		peakColumnIntersections = std::max(peakColumnIntersections, range.m_Count);
 	}
 
-	m_Intersections[m_IntersectionCount++] =
-	{
-		fixture,
-		point,
-		normal,
-		fraction,
-		(int)m_Index
-	};
+	// Publish the nearest opaque surface in each of each view's columns.
+	m_CastDepthBuffers.resize(snapshot.m_Views.size());
 
-	if (m_IntersectionCount >= m_Intersections.size())
+	for (unsigned viewIndex = 0; viewIndex < snapshot.m_Views.size(); viewIndex++)
 	{
-		return 0;
-	}
+		const View& view = snapshot.m_Views[viewIndex];
+		RaycastDepthBuffer& depthBuffer = m_CastDepthBuffers[viewIndex];
 
-	return 1;
-}
+		if (depthBuffer.GetWidth() != (unsigned)view.m_Viewport.width) {
+			depthBuffer.Resize(view.m_Viewport.width);
+		}
+		else {
+			depthBuffer.Clear();
+		}
 
-void WorldRaycastRendererImpl::LoadShader() {
-	static const char* vertexShaderRawText = R"(
-	
-	#version 130
+		for (unsigned i = 0; i < (unsigned)view.m_Viewport.width; i++)
+		{
+			const ColumnRange& range = m_ColumnRanges[view.m_FirstColumn + i];
 
-	uniform vec4 ambientLightColor;
+			// Nearest last.
+			for (unsigned j = range.m_Begin + range.m_Count; j > range.m_Begin; j--)
+			{
+				const Column& column = m_PreparedColumns[j - 1];
+
+				if (column.m_Opaque) {
+					depthBuffer.SetColumn(
+						i, 
+						column.m_Distance, 
+						column.m_Top - view.m_Viewport.top, 
+						column.m_Bottom - view.m_Viewport.top);
+					break;
+				}
+			}
+		}
+	}
 
-	uniform vec4 directionalLightColor;
-	uniform vec2 directionalLightDirection;
+	// Shove all columns into one big array, a layer at a time. Each screen column's
+	// intersections are already sorted, so this draws every column back-to-front.
+	m_LayerEnds.clear();
 
-	uniform vec4 fogColor;
-	uniform float fogMaxIntensity;
-	uniform float fogMaxDistance;
-	uniform float fogMinDistance;
-	
-	out vec4 appliedFogColor;
-	out vec4 appliedDirectionalLightColor;
+	for (unsigned layer = 0; layer < peakColumnIntersections; layer++)
+	{
+		for (const ColumnRange& range : m_ColumnRanges)
+		{
+			if (layer < range.m_Count) {
+				m_AllColumns.push_back(m_PreparedColumns[range.m_Begin + layer]);
+			}
+		}
 
-	void main() {
-		float fogIntensity = 
-			min(
-				((min(
-					max(
-						gl_Vertex.z, 
-						fogMinDistance), 
-					fogMaxDistance) 
-				- fogMinDistance) 
-				/ (fogMaxDistance - fogMinDistance)),
-				fogMaxIntensity);
-		appliedFogColor = fogColor * fogIntensity;
+		m_LayerEnds.push_back(m_AllColumns.size());
+	}
 
-		appliedDirectionalLightColor = 
-			directionalLightColor * 
-			clamp(dot(vec2(gl_Normal), -directionalLightDirection), 0.0f, 1.0f);
+	if (settings.m_BatchColumns)
+	{
+		unsigned layerBegin = 0;
 
-		gl_Position = ftransform();
-		gl_Position.z = 0.0f;
-		
-		gl_FrontColor = ambientLightColor * gl_Color;
-		
-		gl_TexCoord[0] = gl_TextureMatrix[0] * gl_MultiTexCoord0;
+		for (const unsigned layerEnd : m_LayerEnds) {
+			GroupLayerByTexture(layerBegin, layerEnd);
+			layerBegin = layerEnd;
+		}
 	}
 
-	)";
+	m_CastStats = RaycastRenderStats();
+	m_CastStats.m_ColumnCount = m_AllColumns.size();
+	m_CastStats.m_PeakColumnIntersections = peakColumnIntersections;
+	m_CastStats.m_RecastColumnCount = recastColumnCount;
+	m_CastStats.m_CandidateCount = settings.m_FrustumCull ? snapshot.m_Candidates.size() : 0;
+
+	std::swap(m_ColumnRanges, m_PreviousColumnRanges);
+	std::swap(m_PreparedColumns, m_PreviousPreparedColumns);
+}
 
-	static const char* fragmentShaderRawText = R"(
-	
-	#version 130	
+void WorldRaycastRendererImpl::Draw(const Snapshot& snapshot, sf::RenderTarget& target)
+{
+	m_Stats = m_CastStats;
 
-	uniform sampler2D texture;
-	
-	in vec4 appliedFogColor;
-	in vec4 appliedDirectionalLightColor;
+	std::swap(m_DepthBuffers, m_CastDepthBuffers);
 
-	void main() {
-		vec4 blendColor = gl_Color;
-	
-		vec4 textureColor = texture2D(texture, gl_TexCoord[0].xy);
-	
-		gl_FragColor = (blendColor * textureColor) + appliedFogColor + appliedDirectionalLightColor;
+	if (snapshot.m_Settings.m_SoftwareRasterizer)
+	{
+		DrawSoftware(snapshot, target);
 	}
-	
-	)";
+	else
+	{
+		ColumnDrawer drawer(target, m_Resources, snapshot, m_Vertices, m_Stats);
 
-	bool result = mShader.loadFromMemory(vertexShaderRawText, fragmentShaderRawText);
-	assert(result);
+		for (const Column& column : m_AllColumns) {
+			drawer.Draw(column);
+		}
+	}
+}
+
+void WorldRaycastRendererImpl::Render(
+	const World & world,
+	const std::vector<RaycastRenderView>& views,
+	const RenderSettings& settings,
+	sf::RenderTarget & target)
+{
+	// Anything pipelined is out of date now.
+	DiscardFrames();
+
+	Capture(world, views, settings, false);
+
+	const Snapshot& snapshot = m_Snapshots[m_CaptureSnapshot];
+
+	Cast(snapshot);
+	Draw(snapshot, target);
+}
+
+WorldRaycastRendererImpl::~WorldRaycastRendererImpl()
+{
+	if (!m_RenderThread.joinable()) return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_RenderMutex);
+		m_QuitRenderThread = true;
+	}
+
+	m_CastStarted.notify_one();
+
+	m_RenderThread.join();
+}
+
+void WorldRaycastRendererImpl::RenderThreadMain()
+{
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_RenderMutex);
+
+			m_CastStarted.wait(lock, [this]() { return m_QuitRenderThread || m_Casting; });
+
+			if (m_QuitRenderThread) return;
+		}
+
+		Cast(m_Snapshots[1 - m_CaptureSnapshot]);
+
+		{
+			std::lock_guard<std::mutex> lock(m_RenderMutex);
+			m_Casting = false;
+		}
+
+		m_CastFinished.notify_one();
+	}
+}
+
+void WorldRaycastRendererImpl::WaitForCast()
+{
+	std::unique_lock<std::mutex> lock(m_RenderMutex);
+
+	m_CastFinished.wait(lock, [this]() { return !m_Casting; });
+}
+
+void WorldRaycastRendererImpl::CaptureFrame(
+	const World& world,
+	const std::vector<RaycastRenderView>& views,
+	const RenderSettings& settings)
+{
+	// The render thread only reads the other snapshot, so this can go ahead while it works.
+	Capture(world, views, settings, true);
+
+	m_HasCapturedFrame = true;
+}
+
+bool WorldRaycastRendererImpl::WaitForCastFrame()
+{
+	WaitForCast();
+
+	return m_HasCastFrame;
+}
+
+void WorldRaycastRendererImpl::DrawCastFrame(sf::RenderTarget& target)
+{
+	if (!WaitForCastFrame()) return;
+
+	Draw(m_Snapshots[1 - m_CaptureSnapshot], target);
+
+	m_HasCastFrame = false;
+}
+
+void WorldRaycastRendererImpl::CastFrame()
+{
+	if (!m_HasCapturedFrame) return;
+
+	// The last cast frame is dropped if it wasn't drawn.
+	WaitForCast();
+
+	m_CaptureSnapshot = 1 - m_CaptureSnapshot;
+	m_HasCapturedFrame = false;
+	m_HasCastFrame = true;
+
+	if (!m_RenderThread.joinable()) {
+		m_RenderThread = std::thread(&WorldRaycastRendererImpl::RenderThreadMain, this);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_RenderMutex);
+		m_Casting = true;
+	}
+
+	m_CastStarted.notify_one();
+}
+
+void WorldRaycastRendererImpl::DiscardFrames()
+{
+	WaitForCast();
+
+	m_HasCapturedFrame = false;
+	m_HasCastFrame = false;
+}
+
+const Camera3D& WorldRaycastRendererImpl::GetCastCamera(const unsigned view) const
+{
+	return m_Snapshots[1 - m_CaptureSnapshot].m_Views[view].m_Camera;
+}
+
+namespace {
+
+bool operator==(const b2Transform& a, const b2Transform& b) {
+	return a.p == b.p && a.q.s == b.q.s && a.q.c == b.q.c;
+}
+
+bool operator==(const FixtureColumnInfo& a, const FixtureColumnInfo& b) {
+	return
+		a.m_TextureRect == b.m_TextureRect &&
+		a.m_SpriteLeft == b.m_SpriteLeft &&
+		a.m_TexelsPerMetre == b.m_TexelsPerMetre &&
+		a.m_Horizon == b.m_Horizon &&
+		a.m_TopScale == b.m_TopScale &&
+		a.m_BottomScale == b.m_BottomScale &&
+		a.m_BlendColor == b.m_BlendColor &&
+		a.m_Texture == b.m_Texture &&
+		a.m_Opaque == b.m_Opaque;
+}
+
+}
+
+void WorldRaycastRendererImpl::DrawSoftware(const Snapshot& snapshot, sf::RenderTarget& target)
+{
+	const sf::Vector2u targetSize = target.getSize();
+
+	if (m_SoftwareRasterizer.GetWidth() != targetSize.x ||
+		m_SoftwareRasterizer.GetHeight() != targetSize.y)
+	{
+		m_SoftwareRasterizer.SetSize(targetSize.x, targetSize.y);
+		m_SoftwareFrame.create(targetSize.x, targetSize.y);
+	}
+	else
+	{
+		m_SoftwareRasterizer.Clear();
+	}
+
+	SoftwareLighting lighting;
+	lighting.m_Ambient = snapshot.m_AmbientLight;
+	lighting.m_Directional = snapshot.m_DirectionalLight;
+	lighting.m_Fog = snapshot.m_Fog;
+
+	if (snapshot.m_AtlasRevision != m_AtlasRevision) {
+		m_AtlasRevision = snapshot.m_AtlasRevision;
+		m_TextureImages.clear();
+	}
+
+	const sf::Texture* lastTexture = nullptr;
+	SoftwareTexture texture;
+
+	for (const Column& column : m_AllColumns)
+	{
+		// Columns come grouped by texture, so this doesn't happen often.
+		if (column.m_Texture != lastTexture) {
+			lastTexture = column.m_Texture;
+			texture = GetSoftwareTexture(column.m_Texture);
+		}
+
+		m_SoftwareRasterizer.Draw(column, texture, lighting);
+	}
+
+	m_SoftwareRasterizer.CopyPixels(m_SoftwareFramePixels);
+
+	m_SoftwareFrame.update(m_SoftwareFramePixels.data());
+
+	// The framebuffer has premultiplied alpha.
+	target.draw(
+		sf::Sprite(m_SoftwareFrame), 
+		sf::RenderStates(sf::BlendMode(sf::BlendMode::One, sf::BlendMode::OneMinusSrcAlpha)));
+
+	m_Stats.m_DrawCalls = 1;
+}
+
+SoftwareTexture WorldRaycastRendererImpl::GetSoftwareTexture(const sf::Texture* texture)
+{
+	if (!texture) return SoftwareTexture();
+
+	sf::Image& image = m_TextureImages[texture];
+
+	if (image.getSize() != texture->getSize()) {
+		image = texture->copyToImage();
+	}
+
+	SoftwareTexture softwareTexture;
+	softwareTexture.m_Pixels = image.getPixelsPtr();
+	softwareTexture.m_Width = image.getSize().x;
+	softwareTexture.m_Height = image.getSize().y;
+	return softwareTexture;
+}
+
+void WorldRaycastRendererImpl::MarkDirtyColumns(const Snapshot& snapshot)
+{
+	const RenderSettings& settings = snapshot.m_Settings;
+
+	// Without candidates there's no telling what has changed.
+	// With more than one view, it's not worth the bookkeeping.
+	const bool canReuse = settings.m_ReuseColumns && settings.m_FrustumCull && snapshot.m_Views.size() == 1;
+
+	if (!canReuse) {
+		m_DirtyColumns.assign(m_RaycastCallbacks.size(), 1);
+		m_Signatures.clear();
+		m_PreviousSignatures.clear();
+		m_HasPreviousFrame = false;
+		return;
+	}
+
+	const Camera3D& camera = snapshot.m_Views[0].m_Camera;
+
+	const ViewSignature view = {
+		b2Transform(camera.GetPosition(), b2Rot(camera.GetRotation())),
+		camera.GetHeightOffset(),
+		camera.GetPitchRadians(),
+		camera.GetFovRadians(),
+		settings.m_RayLength,
+		snapshot.m_Views[0].m_Viewport
+	};
+
+	const auto SameViewport = [](const sf::IntRect& a, const sf::IntRect& b) {
+		return a.left == b.left && a.top == b.top && a.width == b.width && a.height == b.height;
+	};
+
+	const bool viewChanged = 
+		!m_HasPreviousFrame ||
+		!(view.m_CameraTransform == m_PreviousView.m_CameraTransform) ||
+		view.m_CameraHeightOffset != m_PreviousView.m_CameraHeightOffset ||
+		view.m_CameraPitch != m_PreviousView.m_CameraPitch ||
+		view.m_CameraFov != m_PreviousView.m_CameraFov ||
+		view.m_RayLength != m_PreviousView.m_RayLength ||
+		!SameViewport(view.m_Viewport, m_PreviousView.m_Viewport);
+
+	m_DirtyColumns.assign(m_RaycastCallbacks.size(), viewChanged ? 1 : 0);
+
+	m_Signatures.clear();
+
+	for (unsigned i = 0; i < snapshot.m_Candidates.size(); i++)
+	{
+		const Candidate& candidate = snapshot.m_Candidates[i];
+
+		m_Signatures.push_back({
+			candidate.m_Fixture,
+			candidate.m_ChildIndex,
+			candidate.m_FirstColumn,
+			candidate.m_LastColumn,
+			candidate.m_Transform,
+			snapshot.m_CandidateInfos[i] });
+	}
+
+	const auto ByFixture = [](const CandidateSignature& a, const CandidateSignature& b)
+	{
+		return std::less<const b2Fixture*>()(a.m_Fixture, b.m_Fixture) ||
+			(a.m_Fixture == b.m_Fixture && a.m_ChildIndex < b.m_ChildIndex);
+	};
+
+	std::sort(m_Signatures.begin(), m_Signatures.end(), ByFixture);
+
+	if (!viewChanged)
+	{
+		const auto MarkDirty = [this](const CandidateSignature& signature)
+		{
+			std::fill(
+				m_DirtyColumns.begin() + signature.m_FirstColumn,
+				m_DirtyColumns.begin() + signature.m_LastColumn + 1,
+				1);
+		};
+
+		// Walk both sorted lists together. Anything that has appeared, 
+		// disappeared or changed dirties the columns it covered and covers.
+		auto current = m_Signatures.begin();
+		auto previous = m_PreviousSignatures.begin();
+
+		while (current != m_Signatures.end() || previous != m_PreviousSignatures.end())
+		{
+			if (previous == m_PreviousSignatures.end() ||
+				(current != m_Signatures.end() && ByFixture(*current, *previous)))
+			{
+				MarkDirty(*current++);
+			}
+			else if (current == m_Signatures.end() || ByFixture(*previous, *current))
+			{
+				MarkDirty(*previous++);
+			}
+			else
+			{
+				const bool same =
+					current->m_FirstColumn == previous->m_FirstColumn &&
+					current->m_LastColumn == previous->m_LastColumn &&
+					current->m_Transform == previous->m_Transform &&
+					current->m_Info == previous->m_Info;
+
+				if (!same) {
+					MarkDirty(*current);
+					MarkDirty(*previous);
+				}
+
+				++current;
+				++previous;
+			}
+		}
+	}
+
+	std::swap(m_Signatures, m_PreviousSignatures);
+
+	m_PreviousView = view;
+	m_HasPreviousFrame = true;
+}
+
+void WorldRaycastRendererImpl::GroupLayerByTexture(const unsigned layerBegin, const unsigned layerEnd)
+{
+	// A counting sort on texture. There are normally only a handful of 
+	// textures on screen, so finding each one's index is cheap.
+	m_LayerTextures.clear();
+	m_LayerTextureIndices.resize(layerEnd - layerBegin);
+
+	for (unsigned i = layerBegin; i < layerEnd; i++)
+	{
+		const sf::Texture* texture = m_AllColumns[i].m_Texture;
+
+		unsigned textureIndex = 0;
+
+		// Neighbouring columns usually share a texture, so try the last one first.
+		if (i > layerBegin && m_AllColumns[i - 1].m_Texture == texture)
+		{
+			textureIndex = m_LayerTextureIndices[i - 1 - layerBegin];
+		}
+		else
+		{
+			const auto it = std::find(m_LayerTextures.begin(), m_LayerTextures.end(), texture);
+
+			textureIndex = it - m_LayerTextures.begin();
+
+			if (it == m_LayerTextures.end()) {
+				m_LayerTextures.push_back(texture);
+			}
+		}
+
+		m_LayerTextureIndices[i - layerBegin] = textureIndex;
+	}
+
+	if (m_LayerTextures.size() <= 1) return;
+
+	m_LayerTextureOffsets.assign(m_LayerTextures.size() + 1, 0);
+
+	for (const unsigned textureIndex : m_LayerTextureIndices) {
+		m_LayerTextureOffsets[textureIndex + 1]++;
+	}
+
+	for (unsigned i = 1; i < m_LayerTextureOffsets.size(); i++) {
+		m_LayerTextureOffsets[i] += m_LayerTextureOffsets[i - 1];
+	}
+
+	m_LayerColumns.resize(layerEnd - layerBegin);
+
+	for (unsigned i = layerBegin; i < layerEnd; i++) {
+		const unsigned textureIndex = m_LayerTextureIndices[i - layerBegin];
+		m_LayerColumns[m_LayerTextureOffsets[textureIndex]++] = m_AllColumns[i];
+	}
+
+	std::copy(m_LayerColumns.begin(), m_LayerColumns.end(), m_AllColumns.begin() + layerBegin);
+}
+
+void WorldRaycastRendererImpl::GatherCandidates(
+	const b2World& world,
+	const float interpolation,
+	Snapshot& snapshot)
+{
+	const float rayLength = snapshot.m_Settings.m_RayLength;
+
+	std::vector<View>& views = snapshot.m_Views;
+
+	// Bound the sector swept by each view's rays: the camera, the two outermost ray
+	// ends, and any point on the arc between them that pokes out further along an axis.
+	std::vector<b2AABB> viewBounds(views.size());
+
+	for (unsigned viewIndex = 0; viewIndex < views.size(); viewIndex++)
+	{
+		const View& view = views[viewIndex];
+		b2AABB& bounds = viewBounds[viewIndex];
+
+		bounds.lowerBound = view.m_Position;
+		bounds.upperBound = view.m_Position;
+
+		auto Extend = [&bounds](const b2Vec2& p) {
+			bounds.lowerBound = b2Min(bounds.lowerBound, p);
+			bounds.upperBound = b2Max(bounds.upperBound, p);
+		};
+
+		b2Vec2 edgeDir = view.m_Forwards + view.m_ViewPlane;
+		edgeDir.Normalize();
+
+		const float cosHalfAngle = b2Dot(edgeDir, view.m_Forwards);
+
+		Extend(view.m_Position + rayLength * edgeDir);
+		Extend(view.m_Position + rayLength * b2Vec2(2.0f * cosHalfAngle * view.m_Forwards - edgeDir));
+
+		for (const b2Vec2& axis : { b2Vec2(1, 0), b2Vec2(-1, 0), b2Vec2(0, 1), b2Vec2(0, -1) }) {
+			if (b2Dot(axis, view.m_Forwards) >= cosHalfAngle) {
+				Extend(view.m_Position + rayLength * axis);
+			}
+		}
+	}
+
+	// One query covers every view.
+	b2AABB queryBounds = viewBounds[0];
+
+	for (const b2AABB& bounds : viewBounds) {
+		queryBounds.Combine(bounds);
+	}
+
+	const b2BroadPhase& broadPhase = world.GetContactManager().m_broadPhase;
+
+	struct ProxyQuery {
+		const b2BroadPhase& m_BroadPhase;
+		std::vector<const b2FixtureProxy*> m_Proxies;
+
+		bool QueryCallback(int32 proxyId) {
+			m_Proxies.push_back((const b2FixtureProxy*)m_BroadPhase.GetUserData(proxyId));
+			return true;
+		}
+	};
+
+	ProxyQuery query{ broadPhase };
+
+	broadPhase.Query(&query, queryBounds);
+
+	for (unsigned viewIndex = 0; viewIndex < views.size(); viewIndex++)
+	{
+		View& view = views[viewIndex];
+
+		view.m_FirstCandidate = snapshot.m_Candidates.size();
+
+		const b2Vec2 right(-view.m_Forwards.y, view.m_Forwards.x);
+		const float viewPlaneWidthModifier = view.m_Camera.GetViewPlaneWidthModifier();
+		const int viewWidth = view.m_Viewport.width;
+
+		for (const b2FixtureProxy* proxy : query.m_Proxies)
+		{
+			if (proxy->fixture->GetUserData() == nullptr) continue;
+
+			const auto& renderData = *(const FixtureRenderData*)proxy->fixture->GetUserData();
+
+			// A detached sprite's fixture is only rotated to face one camera, so project
+			// the sprite as it would be if it was facing this one.
+			const bool billboard = renderData.IsDetached();
+
+			const b2Body& body = *proxy->fixture->GetBody();
+
+			b2Transform transform = body.GetTransform();
+			b2AABB aabb = proxy->aabb;
+
+			const auto physicsComponent = (const PhysicsComponent*)body.GetUserData();
+
+			// The shape is copied, so it can be cast against wherever it's drawn.
+			if (!billboard && physicsComponent != nullptr && interpolation < 1.0f) {
+				transform = physicsComponent->GetInterpolatedTransform(interpolation);
+				proxy->fixture->GetShape()->ComputeAABB(&aabb, transform, proxy->childIndex);
+			}
+
+			if (!billboard && !b2TestOverlap(aabb, viewBounds[viewIndex])) continue;
+
+			int firstColumn = 0;
+			int lastColumn = viewWidth - 1;
+
+			const b2Vec2 spriteOffset = renderData.GetSpriteRadius() * right;
+
+			// Project the corners of the fixture's AABB onto the screen. If any of
+			// them are level with or behind the camera, just test every column.
+			const b2Vec2 aabbCorners[] = {
+				aabb.lowerBound,
+				aabb.upperBound,
+				b2Vec2(aabb.lowerBound.x, aabb.upperBound.y),
+				b2Vec2(aabb.upperBound.x, aabb.lowerBound.y)
+			};
+
+			const b2Vec2 billboardCorners[] = {
+				renderData.GetSpritePosition() - spriteOffset,
+				renderData.GetSpritePosition() + spriteOffset
+			};
+
+			const b2Vec2* const cornersBegin = billboard ? billboardCorners : aabbCorners;
+			const b2Vec2* const cornersEnd = billboard ? std::end(billboardCorners) : std::end(aabbCorners);
+
+			float minScreenX = b2_maxFloat;
+			float maxScreenX = -b2_maxFloat;
+			bool behindCamera = false;
+
+			for (const b2Vec2* corner = cornersBegin; corner != cornersEnd; ++corner) {
+				const b2Vec2 displacement = *corner - view.m_Position;
+				const float depth = b2Dot(displacement, view.m_Forwards);
+
+				if (depth <= b2_epsilon) {
+					behindCamera = true;
+					break;
+				}
+
+				const float screenX = b2Dot(displacement, right) / (depth * viewPlaneWidthModifier);
+
+				minScreenX = std::min(minScreenX, screenX);
+				maxScreenX = std::max(maxScreenX, screenX);
+			}
+
+			// A billboard lies across the view, so it's all behind the camera or none of it is.
+			if (billboard && behindCamera) continue;
+
+			if (!behindCamera)
+			{
+				// Pad by a column either side to soak up rounding.
+				firstColumn = (int)std::floor((minScreenX + 1.0f) / view.m_ScreenXDelta) - 1;
+				lastColumn = (int)std::ceil((maxScreenX + 1.0f) / view.m_ScreenXDelta) + 1;
+
+				if (lastColumn < 0 || firstColumn > viewWidth - 1) continue;
+
+				firstColumn = std::max(firstColumn, 0);
+				lastColumn = std::min(lastColumn, viewWidth - 1);
+			}
+
+			const b2Shape& shape = *proxy->fixture->GetShape();
+
+			b2Shape::Type shapeType = shape.GetType();
+			unsigned shapeIndex = 0;
+
+			switch (shapeType)
+			{
+			case b2Shape::e_circle:
+				shapeIndex = snapshot.m_Circles.size();
+				snapshot.m_Circles.push_back((const b2CircleShape&)shape);
+				break;
+			case b2Shape::e_edge:
+				shapeIndex = snapshot.m_Edges.size();
+				snapshot.m_Edges.push_back((const b2EdgeShape&)shape);
+				break;
+			case b2Shape::e_polygon:
+				shapeIndex = snapshot.m_Polygons.size();
+				snapshot.m_Polygons.push_back((const b2PolygonShape&)shape);
+				break;
+			case b2Shape::e_chain:
+				shapeType = b2Shape::e_edge;
+				shapeIndex = snapshot.m_Edges.size();
+				snapshot.m_Edges.emplace_back();
+				((const b2ChainShape&)shape).GetChildEdge(&snapshot.m_Edges.back(), proxy->childIndex);
+				break;
+			default:
+				continue;
+			}
+
+			snapshot.m_Candidates.push_back({
+				proxy->fixture,
+				proxy->childIndex,
+				firstColumn + (int)view.m_FirstColumn,
+				lastColumn + (int)view.m_FirstColumn,
+				viewIndex,
+				billboard,
+				renderData.GetSpritePosition(),
+				renderData.GetSpriteRadius(),
+				transform,
+				shapeType,
+				shapeIndex });
+		}
+
+		view.m_EndCandidate = snapshot.m_Candidates.size();
+	}
+}
+
+WorldRaycastRendererImpl::ColumnDrawer::ColumnDrawer(
+	sf::RenderTarget& target,
+	RenderResources& resources,
+	const Snapshot& snapshot,
+	std::vector<Vertex>& vertices,
+	RaycastRenderStats& stats)
+	: m_Target(target)
+	, m_Shader(resources.GetRaycastShader())
+	, m_Batch(snapshot.m_Settings.m_BatchColumns)
+	, m_DefaultTexture(resources.GetDefaultTexture())
+	, m_Vertices(vertices)
+	, m_Stats(stats)
+{
+	// The uniforms live in the program, so they only need uploading when they change.
+	resources.SetLighting(snapshot.m_AmbientLight, snapshot.m_DirectionalLight, snapshot.m_Fog);
+
+	// Columns are in the target's pixel coordinates, whatever view was last used to draw to it.
+	{
+		const sf::Vector2u size = target.getSize();
+		glCheck(glViewport(0, 0, size.x, size.y));
+		glCheck(glMatrixMode(GL_PROJECTION));
+		glCheck(glLoadMatrixf(target.getDefaultView().getTransform().getMatrix()));
+		glCheck(glMatrixMode(GL_MODELVIEW));
+		glCheck(glLoadIdentity());
+	}
+
+	sf::Shader::bind(&m_Shader);
+
+	sf::Texture::bind(&m_DefaultTexture, sf::Texture::CoordinateType::Pixels);
+	m_Shader.setUniform("texture", sf::Shader::CurrentTexture);
+
+	glCheck(glEnableClientState(GL_VERTEX_ARRAY));
+	glCheck(glEnableClientState(GL_COLOR_ARRAY));
+	glCheck(glEnableClientState(GL_TEXTURE_COORD_ARRAY));
+	glCheck(glEnableClientState(GL_NORMAL_ARRAY));
+
+	m_Vertices.clear();
+}
+
+WorldRaycastRendererImpl::ColumnDrawer::~ColumnDrawer()
+{
+	Flush();
+
+	m_Target.resetGLStates();
+}
+
+void WorldRaycastRendererImpl::ColumnDrawer::Draw(const Column& column)
+{
+	if (column.m_Texture != m_LastTexture) {
+		// Everything queued so far was textured with the previous texture.
+		Flush();
+
+		m_LastTexture = column.m_Texture;
+
+		const sf::Texture* textureToBind;
+
+		if (column.m_Texture)
+		{
+			textureToBind = column.m_Texture;
+		}
+		else
+		{
+			textureToBind = &m_DefaultTexture;
+		}
+
+		sf::Texture::bind(textureToBind, sf::Texture::CoordinateType::Pixels);
+		m_Shader.setUniform("texture", sf::Shader::CurrentTexture);
+
+		m_Stats.m_TextureBinds++;
+	}
+
+	Vertex line[2];
+
+	line[0].position.x = column.m_X;
+	line[1].position.x = column.m_X;
+	line[0].position.y = column.m_Top;
+	line[1].position.y = column.m_Bottom;
+	line[0].position.z = column.m_Distance;
+	line[1].position.z = column.m_Distance;
+
+	line[0].normal = column.m_Normal;
+	line[1].normal = column.m_Normal;
+
+	line[0].color = column.m_BlendColor;
+	line[1].color = column.m_BlendColor;
+
+	line[0].texCoords.x = column.m_U;
+	line[0].texCoords.y = column.m_VTop;
+	line[1].texCoords.x = column.m_U;
+	line[1].texCoords.y = column.m_VBottom;
+
+	m_Vertices.push_back(line[0]);
+	m_Vertices.push_back(line[1]);
+
+	if (!m_Batch) {
+		Flush();
+	}
+}
+
+void WorldRaycastRendererImpl::ColumnDrawer::Flush()
+{
+	if (m_Vertices.empty()) return;
+
+	// The vertex array may have been reallocated since the last draw.
+	glCheck(glVertexPointer(3, GL_FLOAT, sizeof(Vertex), &m_Vertices[0].position));
+	glCheck(glNormalPointer(GL_FLOAT, sizeof(Vertex), &m_Vertices[0].normal));
+	glCheck(glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), &m_Vertices[0].color));
+	glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), &m_Vertices[0].texCoords));
+
+	glCheck(glDrawArrays(GL_LINES, 0, m_Vertices.size()));
+
+	m_Stats.m_DrawCalls++;
+	m_Stats.m_VertexCount += m_Vertices.size();
+
+	m_Vertices.clear();
+}
+
+float32 WorldRaycastRendererImpl::RaycastCallback::ReportFixture(b2Fixture * fixture, const b2Vec2 & point, const b2Vec2 & normal, float32 fraction)
+{
+	if (fixture->GetUserData() == nullptr)
+	{
+		return 1;
+	}
+
+	const auto& renderData = *(qvr::FixtureRenderData*)(fixture->GetUserData());
+
+	return ReportIntersection(fixture, point, normal, fraction, renderData.IsOpaque());
+}
+
+float32 WorldRaycastRendererImpl::RaycastCallback::ReportIntersection(
+	b2Fixture * fixture, 
+	const b2Vec2 & point, 
+	const b2Vec2 & normal, 
+	float32 fraction, 
+	const bool opaque)
+{
+	m_Arena->push_back(
+	{
+		fixture,
+		point,
+		normal,
+		fraction,
+		(int)m_Index,
+		m_ReportingCandidate
+	});
+
+	m_IntersectionCount++;
+
+	if (opaque)
+	{
+		m_OpaqueFraction = std::min(m_OpaqueFraction, fraction);
+
+		// Clip the ray so that nothing further away gets reported.
+		return fraction;
+	}
+
+	return 1;
+}
+
+void WorldRaycastRendererImpl::RaycastCallback::SortFarthestFirst()
+{
+	RayIntersection* const first = m_Arena->data() + m_FirstIntersection;
+	RayIntersection* const last = first + m_IntersectionCount;
+
+	const auto FurtherAway = [](const RayIntersection& a, const RayIntersection& b)
+	{
+		return a.m_fraction > b.m_fraction;
+	};
+
+	// Most columns only hit a few things, which insertion sort handles best.
+	if (m_IntersectionCount > 16) {
+		std::sort(first, last, FurtherAway);
+		return;
+	}
+
+	for (RayIntersection* i = first + 1; i < last; i++)
+	{
+		const RayIntersection intersection = *i;
+
+		RayIntersection* j = i;
+
+		for (; j > first && FurtherAway(intersection, *(j - 1)); j--) {
+			*j = *(j - 1);
+		}
+
+		*j = intersection;
+	}
+}
+
+void WorldRaycastRendererImpl::RaycastCallback::Begin(HitArena& arena)
+{
+	m_Arena = &arena;
+	m_FirstIntersection = arena.size();
+	m_IntersectionCount = 0;
+	m_OpaqueFraction = 1.0f;
+}
+
+void WorldRaycastRendererImpl::RaycastCallback::RemoveHiddenIntersections()
+{
+	// Fixtures are reported in no particular order, so some of the
+	// intersections may have been recorded before the ray was clipped.
+	const auto begin = m_Arena->begin() + m_FirstIntersection;
+
+	const auto newEnd = std::remove_if(begin, m_Arena->end(),
+		[this](const RayIntersection& intersection)
+	{
+		return intersection.m_fraction > m_OpaqueFraction;
+	});
+
+	// This column's intersections are at the end of the arena, so they can just be chopped off.
+	m_Arena->erase(newEnd, m_Arena->end());
+
+	m_IntersectionCount = m_Arena->size() - m_FirstIntersection;
 }
 
 WorldRaycastRenderer::WorldRaycastRenderer()
 	: m_Impl(std::make_unique<WorldRaycastRendererImpl>())
 {}
 
+WorldRaycastRenderer::WorldRaycastRenderer(RenderResources& resources)
+	: m_Impl(std::make_unique<WorldRaycastRendererImpl>(resources))
+{}
+
 WorldRaycastRenderer::~WorldRaycastRenderer() = default;
 
+const RaycastRenderStats& WorldRaycastRenderer::GetLastFrameStats() const
+{
+	return m_Impl->GetStats();
+}
+
+const RaycastDepthBuffer& WorldRaycastRenderer::GetDepthBuffer(const unsigned view) const
+{
+	return m_Impl->GetDepthBuffer(view);
+}
+
+void WorldRaycastRenderer::GuiPerformanceInfo() const
+{
+	const RaycastRenderStats& stats = GetLastFrameStats();
+
+	ImGui::Text("Candidates:     %u", stats.m_CandidateCount);
+	ImGui::Text("Columns:        %u", stats.m_ColumnCount);
+	ImGui::Text("Recast Columns: %u", stats.m_RecastColumnCount);
+	ImGui::Text("Peak Column Hits: %u", stats.m_PeakColumnIntersections);
+	ImGui::Text("Draw Calls:     %u", stats.m_DrawCalls);
+	ImGui::Text("Vertices:       %u", stats.m_VertexCount);
+	ImGui::Text("Texture Binds:  %u", stats.m_TextureBinds);
+}
+
 void WorldRaycastRenderer::Render(
 	const World & world,
 	const Camera3D & camera,
 	const RenderSettings& settings,
 	sf::RenderTarget & target)
 {
-	m_Impl->Render(world, camera, settings, target);
+	const sf::Vector2u targetSize = target.getSize();
+
+	m_Impl->Render(
+		world, 
+		{ RaycastRenderView{ &camera, sf::IntRect(0, 0, targetSize.x, targetSize.y) } }, 
+		settings, 
+		target);
 }
 
-}
\ No newline at end of file
+void WorldRaycastRenderer::Render(
+	const World& world,
+	const std::vector<RaycastRenderView>& views,
+	const RenderSettings& settings,
+	sf::RenderTarget& target)
+{
+	m_Impl->Render(world, views, settings, target);
+}
+
+void WorldRaycastRenderer::CaptureFrame(
+	const World& world,
+	const std::vector<RaycastRenderView>& views,
+	const RenderSettings& settings)
+{
+	m_Impl->CaptureFrame(world, views, settings);
+}
+
+bool WorldRaycastRenderer::WaitForCastFrame()
+{
+	return m_Impl->WaitForCastFrame();
+}
+
+const Camera3D& WorldRaycastRenderer::GetCastCamera(const unsigned view) const
+{
+	return m_Impl->GetCastCamera(view);
+}
+
+void WorldRaycastRenderer::DrawCastFrame(sf::RenderTarget& target)
+{
+	m_Impl->DrawCastFrame(target);
+}
+
+void WorldRaycastRenderer::CastFrame()
+{
+	m_Impl->CastFrame();
+}
+
+void WorldRaycastRenderer::DiscardFrames()
+{
+	m_Impl->DiscardFrames();
+}
+
+}
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <memory>
+#include <vector>
+
+#include <SFML/Graphics/Rect.hpp>
 
 class b2World;
 
@@ -12,17 +15,84 @@ class RenderTarget;
 namespace qvr {
 
 class Camera3D;
+class RaycastDepthBuffer;
+class RenderResources;
 class World;
 class WorldRaycastRendererImpl;
 struct RenderSettings;
 
+// Counters describing the work done by the last WorldRaycastRenderer::Render call.
+struct RaycastRenderStats
+{
+	unsigned m_CandidateCount = 0;
+	unsigned m_ColumnCount = 0;
+	// Screen columns whose rays were cast, rather than carried over from the last frame.
+	unsigned m_RecastColumnCount = 0;
+	// The most intersections any one column's ray collected.
+	unsigned m_PeakColumnIntersections = 0;
+	unsigned m_DrawCalls = 0;
+	unsigned m_VertexCount = 0;
+	unsigned m_TextureBinds = 0;
+};
+
+// A camera, and the part of the target it's drawn into.
+struct RaycastRenderView
+{
+	const Camera3D* m_Camera;
+	sf::IntRect m_Viewport;
+};
+
 // Takes over the raycasting stage of 3D World rendering from World::Render3D.
 class WorldRaycastRenderer
 {
 public:
+	// Creates its own RenderResources.
 	WorldRaycastRenderer();
+	// Shares resources with other WorldRaycastRenderers. They must outlive it.
+	WorldRaycastRenderer(RenderResources& resources);
 	~WorldRaycastRenderer();
 	void Render(const World& world, const Camera3D& camera, const RenderSettings& settings, sf::RenderTarget& target);
+
+	// Draws each view into its viewport. The broad-phase is queried once for all of them,
+	// and all of their columns are cast in the same parallel job.
+	void Render(
+		const World& world, 
+		const std::vector<RaycastRenderView>& views, 
+		const RenderSettings& settings, 
+		sf::RenderTarget& target);
+
+	// Pipelined rendering, for when the World's next step should go ahead while this frame's
+	// rays are cast on the render thread. Each frame, in this order:
+	//  - CaptureFrame copies what the frame needs out of the World. Rays are always frustum culled.
+	//  - WaitForCastFrame waits for the frame captured last time to be cast. If there is one,
+	//    GetCastCamera and DrawCastFrame can be used to draw it.
+	//  - CastFrame hands the frame that was just captured to the render thread.
+	// The picture is one frame behind the World. OpenGL is only ever used on the calling thread.
+	void CaptureFrame(
+		const World& world,
+		const std::vector<RaycastRenderView>& views,
+		const RenderSettings& settings);
+
+	bool WaitForCastFrame();
+
+	// The given view's camera, as it was when the cast frame was captured.
+	const Camera3D& GetCastCamera(const unsigned view = 0) const;
+
+	void DrawCastFrame(sf::RenderTarget& target);
+
+	void CastFrame();
+
+	// Waits for the render thread and forgets the frames in the pipeline. Must be called 
+	// before the World they were captured from, or any of its textures, are destroyed.
+	void DiscardFrames();
+
+	const RaycastRenderStats& GetLastFrameStats() const;
+
+	// The nearest opaque surface in each column of the given view, last frame.
+	// It's in the view's coordinates, not the target's.
+	const RaycastDepthBuffer& GetDepthBuffer(const unsigned view = 0) const;
+
+	void GuiPerformanceInfo() const;
 private:
 	std::unique_ptr<WorldRaycastRendererImpl> m_Impl;
 };
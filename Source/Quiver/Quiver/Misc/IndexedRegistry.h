@@ -0,0 +1,129 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace qvr {
+
+// Where something is in an IndexedRegistry, kept by the thing itself so that it can be
+// found without searching. Copies start out unregistered.
+class RegistryIndex {
+public:
+	RegistryIndex() = default;
+	RegistryIndex(const RegistryIndex&) {}
+
+	RegistryIndex& operator=(const RegistryIndex&) { return *this; }
+
+	bool IsRegistered() const { return m_Index >= 0; }
+
+private:
+	template<typename T>
+	friend class IndexedRegistry;
+
+	int m_Index = -1;
+};
+
+// An unordered list of things registered by address, with constant time adding and removing.
+// T needs a GetRegistryIndex() that returns a RegistryIndex&, which makes T registrable
+// with one IndexedRegistry at a time.
+// Removing something moves the last thing into its place, so the order changes.
+// If things could be removed while iterating, call DeferRemovals first: their places are
+// nulled out until ApplyRemovals fills them in, and iterating gives null for each one.
+template<typename T>
+class IndexedRegistry
+{
+public:
+	using const_iterator = typename std::vector<T*>::const_iterator;
+
+	// Returns false if the thing is already registered.
+	bool Add(T& item)
+	{
+		RegistryIndex& index = item.GetRegistryIndex();
+
+		if (index.IsRegistered()) return false;
+
+		index.m_Index = m_Items.size();
+		m_Items.push_back(&item);
+
+		return true;
+	}
+
+	// Returns false if the thing isn't registered here.
+	bool Remove(T& item)
+	{
+		if (!Contains(item)) return false;
+
+		RegistryIndex& index = item.GetRegistryIndex();
+
+		if (m_DeferringRemovals) {
+			m_Items[index.m_Index] = nullptr;
+			m_Holes.push_back(index.m_Index);
+		}
+		else {
+			RemoveAt(index.m_Index);
+		}
+
+		index.m_Index = -1;
+
+		return true;
+	}
+
+	bool Contains(T& item) const { return GetIndex(item) >= 0; }
+
+	// -1 if the thing isn't registered here.
+	int GetIndex(T& item) const
+	{
+		const int index = item.GetRegistryIndex().m_Index;
+
+		if (index < 0 || index >= (int)m_Items.size() || m_Items[index] != &item) return -1;
+
+		return index;
+	}
+
+	// Null if what was here has been removed since DeferRemovals.
+	T* Get(const int index) const { return m_Items[index]; }
+
+	void DeferRemovals() { m_DeferringRemovals = true; }
+
+	void ApplyRemovals()
+	{
+		m_DeferringRemovals = false;
+
+		// Going from the back means the last item is never a hole when one gets filled.
+		std::sort(m_Holes.begin(), m_Holes.end(), std::greater<int>());
+
+		for (const int hole : m_Holes) {
+			RemoveAt(hole);
+		}
+
+		m_Holes.clear();
+	}
+
+	unsigned size() const { return m_Items.size(); }
+	bool empty() const { return m_Items.empty(); }
+
+	const_iterator begin() const { return m_Items.begin(); }
+	const_iterator end() const { return m_Items.end(); }
+
+private:
+	void RemoveAt(const int index)
+	{
+		const int lastIndex = m_Items.size() - 1;
+
+		if (index != lastIndex) {
+			m_Items[index] = m_Items[lastIndex];
+			m_Items[index]->GetRegistryIndex().m_Index = index;
+		}
+
+		m_Items.pop_back();
+	}
+
+	std::vector<T*> m_Items;
+
+	std::vector<int> m_Holes;
+
+	bool m_DeferringRemovals = false;
+};
+
+}
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace qvr {
+
+// Identifies a value in a SlotMap. The slot's index is in the low 32 bits and its
+// generation is in the high 32 bits. Generations start at 1, so 0 is never a valid key.
+using SlotMapKey = std::uint64_t;
+
+inline std::uint32_t GetSlotIndex(const SlotMapKey key) { return (std::uint32_t)key; }
+inline std::uint32_t GetSlotGeneration(const SlotMapKey key) { return (std::uint32_t)(key >> 32); }
+
+// The bookkeeping half of a SlotMap. Hands out keys to positions in dense arrays that
+// are kept elsewhere, like one array per field for structure-of-arrays storage.
+// Whoever owns the arrays has to keep them in step: push_back on Insert, and on RemoveAt
+// move the last element into the removed one's position and pop_back.
+class SlotIndex
+{
+public:
+	// The new value's position is the old size().
+	SlotMapKey Insert()
+	{
+		std::uint32_t slotIndex;
+
+		if (m_FreeSlots.empty()) {
+			slotIndex = m_Slots.size();
+			m_Slots.push_back(Slot{ 0, 1 });
+		}
+		else {
+			slotIndex = m_FreeSlots.back();
+			m_FreeSlots.pop_back();
+		}
+
+		Slot& slot = m_Slots[slotIndex];
+		slot.m_ValueIndex = m_ValueSlots.size();
+
+		m_ValueSlots.push_back(slotIndex);
+
+		return MakeKey(slotIndex, slot.m_Generation);
+	}
+
+	// The position of the key's value, or -1 if the key is stale.
+	int Find(const SlotMapKey key) const
+	{
+		const std::uint32_t slotIndex = GetSlotIndex(key);
+
+		if (slotIndex >= m_Slots.size()) return -1;
+
+		const Slot& slot = m_Slots[slotIndex];
+
+		if (slot.m_Generation != GetSlotGeneration(key)) return -1;
+
+		// A free slot already has the generation its next value will get.
+		if (!IsOccupied(slotIndex)) return -1;
+
+		return (int)slot.m_ValueIndex;
+	}
+
+	void RemoveAt(const unsigned valueIndex)
+	{
+		const std::uint32_t slotIndex = m_ValueSlots[valueIndex];
+		const std::uint32_t lastIndex = m_ValueSlots.size() - 1;
+
+		// Fill the hole with the last value.
+		if (valueIndex != lastIndex) {
+			m_ValueSlots[valueIndex] = m_ValueSlots[lastIndex];
+			m_Slots[m_ValueSlots[valueIndex]].m_ValueIndex = valueIndex;
+		}
+
+		m_ValueSlots.pop_back();
+
+		Slot& slot = m_Slots[slotIndex];
+		slot.m_Generation = NextGeneration(slot.m_Generation);
+		m_FreeSlots.push_back(slotIndex);
+	}
+
+	// The key of the value at the given position.
+	SlotMapKey GetKey(const unsigned valueIndex) const
+	{
+		const std::uint32_t slotIndex = m_ValueSlots[valueIndex];
+		return MakeKey(slotIndex, m_Slots[slotIndex].m_Generation);
+	}
+
+	void Reserve(const unsigned count)
+	{
+		m_ValueSlots.reserve(count);
+		m_Slots.reserve(count);
+	}
+
+	// Keys to every value go stale, as if each one had been removed.
+	void Clear()
+	{
+		m_FreeSlots.clear();
+
+		for (std::uint32_t slotIndex = 0; slotIndex < m_Slots.size(); slotIndex++) {
+			Slot& slot = m_Slots[slotIndex];
+
+			if (IsOccupied(slotIndex)) {
+				slot.m_Generation = NextGeneration(slot.m_Generation);
+			}
+
+			m_FreeSlots.push_back(slotIndex);
+		}
+
+		m_ValueSlots.clear();
+	}
+
+	unsigned size() const { return m_ValueSlots.size(); }
+
+private:
+	struct Slot {
+		std::uint32_t m_ValueIndex;
+		std::uint32_t m_Generation;
+	};
+
+	static SlotMapKey MakeKey(const std::uint32_t index, const std::uint32_t generation)
+	{
+		return ((SlotMapKey)generation << 32) | index;
+	}
+
+	static std::uint32_t NextGeneration(const std::uint32_t generation)
+	{
+		// Skip 0 when it wraps around.
+		return generation == UINT32_MAX ? 1 : generation + 1;
+	}
+
+	bool IsOccupied(const std::uint32_t slotIndex) const
+	{
+		const std::uint32_t valueIndex = m_Slots[slotIndex].m_ValueIndex;
+		return valueIndex < m_ValueSlots.size() && m_ValueSlots[valueIndex] == slotIndex;
+	}
+
+	// The slot each value belongs to.
+	std::vector<std::uint32_t> m_ValueSlots;
+
+	std::vector<Slot> m_Slots;
+
+	std::vector<std::uint32_t> m_FreeSlots;
+};
+
+// Stores values contiguously, and hands out keys that look them up in constant time
+// without hashing. Removing a value bumps its slot's generation, so any keys to it
+// go stale instead of finding whatever gets put in the slot next.
+// Values are moved around when others are removed, so don't hold on to pointers to them.
+template<typename T>
+class SlotMap
+{
+public:
+	using iterator = typename std::vector<T>::iterator;
+	using const_iterator = typename std::vector<T>::const_iterator;
+
+	SlotMapKey Insert(T value)
+	{
+		m_Values.push_back(std::move(value));
+		return m_Index.Insert();
+	}
+
+	// Returns false if the key was stale.
+	bool Remove(const SlotMapKey key)
+	{
+		const int valueIndex = m_Index.Find(key);
+
+		if (valueIndex < 0) return false;
+
+		const int lastIndex = m_Values.size() - 1;
+
+		// The value is only destroyed once the map is back in a consistent state,
+		// in case its destructor has something to say to the map.
+		T removed = std::move(m_Values[valueIndex]);
+
+		if (valueIndex != lastIndex) {
+			m_Values[valueIndex] = std::move(m_Values[lastIndex]);
+		}
+
+		m_Values.pop_back();
+		m_Index.RemoveAt(valueIndex);
+
+		return true;
+	}
+
+	// Null if the key is stale.
+	T* Get(const SlotMapKey key)
+	{
+		const int valueIndex = m_Index.Find(key);
+		return valueIndex >= 0 ? &m_Values[valueIndex] : nullptr;
+	}
+
+	const T* Get(const SlotMapKey key) const
+	{
+		const int valueIndex = m_Index.Find(key);
+		return valueIndex >= 0 ? &m_Values[valueIndex] : nullptr;
+	}
+
+	bool Contains(const SlotMapKey key) const { return m_Index.Find(key) >= 0; }
+
+	// The key of the value at the given position in iteration order.
+	SlotMapKey GetKey(const unsigned valueIndex) const { return m_Index.GetKey(valueIndex); }
+
+	void Reserve(const unsigned count)
+	{
+		m_Values.reserve(count);
+		m_Index.Reserve(count);
+	}
+
+	// Keys to the removed values go stale, as if each one had been removed.
+	void Clear()
+	{
+		// Swap the values out first, for the same reason as in Remove.
+		std::vector<T> removed;
+		removed.swap(m_Values);
+
+		m_Index.Clear();
+	}
+
+	unsigned size() const { return m_Values.size(); }
+	bool empty() const { return m_Values.empty(); }
+
+	// Iterates over the values in no particular order.
+	iterator begin() { return m_Values.begin(); }
+	iterator end() { return m_Values.end(); }
+	const_iterator begin() const { return m_Values.begin(); }
+	const_iterator end() const { return m_Values.end(); }
+
+private:
+	std::vector<T> m_Values;
+
+	SlotIndex m_Index;
+};
+
+}
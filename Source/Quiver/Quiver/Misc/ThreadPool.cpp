@@ -0,0 +1,216 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace qvr {
+
+ThreadPool::ThreadPool(const unsigned threadCount)
+{
+	SetThreadCount(threadCount);
+}
+
+ThreadPool::~ThreadPool()
+{
+	StopWorkers();
+}
+
+unsigned ThreadPool::ResolveThreadCount(const unsigned threadCount)
+{
+	if (threadCount > 0) return threadCount;
+
+	return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+void ThreadPool::SetThreadCount(const unsigned threadCount)
+{
+	const unsigned resolvedCount = ResolveThreadCount(threadCount);
+
+	if (resolvedCount == GetThreadCount()) return;
+
+	StopWorkers();
+
+	m_Quit = false;
+
+	m_WorkRanges.reset(new WorkRange[resolvedCount]);
+
+	for (unsigned i = 0; i < resolvedCount; i++) {
+		m_WorkRanges[i].m_Range = PackRange(0, 0);
+	}
+
+	// The calling thread is the first 'worker'.
+	for (unsigned i = 1; i < resolvedCount; i++) {
+		m_Workers.emplace_back(&ThreadPool::WorkerMain, this, i, m_JobGeneration);
+	}
+}
+
+void ThreadPool::ParallelFor(const int count, const std::function<void(int)>& func)
+{
+	ParallelForPerThread(count, [&func](const int index, unsigned) { func(index); });
+}
+
+void ThreadPool::ParallelForPerThread(const int count, const std::function<void(int, unsigned)>& func)
+{
+	if (count <= 0) return;
+
+	// Nothing to be gained from waking the workers up.
+	if (m_Workers.empty() || count == 1) {
+		for (int i = 0; i < count; i++) {
+			func(i, 0);
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		m_JobFunc = &func;
+		m_JobCount = count;
+		m_BusyWorkers = m_Workers.size();
+
+		const unsigned threadCount = GetThreadCount();
+
+		for (unsigned i = 0; i < threadCount; i++) {
+			m_WorkRanges[i].m_Range =
+				PackRange(
+					(int)(((long long)count * i) / threadCount),
+					(int)(((long long)count * (i + 1)) / threadCount));
+		}
+
+		m_JobGeneration++;
+	}
+
+	m_JobStarted.notify_all();
+
+	RunJob(0);
+
+	std::unique_lock<std::mutex> lock(m_Mutex);
+
+	m_JobFinished.wait(lock, [this]() { return m_BusyWorkers == 0; });
+
+	m_JobFunc = nullptr;
+}
+
+void ThreadPool::RunJob(const unsigned threadIndex)
+{
+	// Take work in small chunks so that there's something left to steal 
+	// when other threads finish early.
+	const int chunkSize = std::max(1, m_JobCount / (int)(GetThreadCount() * 8));
+
+	for (;;)
+	{
+		int begin, end;
+
+		if (!TakeWork(threadIndex, chunkSize, begin, end)) {
+			// Only give up once there's nothing left anywhere.
+			if (!StealWork(threadIndex)) break;
+			continue;
+		}
+
+		for (int i = begin; i < end; i++) {
+			(*m_JobFunc)(i, threadIndex);
+		}
+	}
+}
+
+bool ThreadPool::TakeWork(const unsigned threadIndex, const int chunkSize, int& begin, int& end)
+{
+	std::atomic<std::uint64_t>& range = m_WorkRanges[threadIndex].m_Range;
+
+	std::uint64_t current = range.load();
+
+	for (;;)
+	{
+		const int rangeBegin = GetRangeBegin(current);
+		const int rangeEnd = GetRangeEnd(current);
+
+		if (rangeBegin >= rangeEnd) return false;
+
+		const int chunkEnd = std::min(rangeBegin + chunkSize, rangeEnd);
+
+		if (range.compare_exchange_weak(current, PackRange(chunkEnd, rangeEnd))) {
+			begin = rangeBegin;
+			end = chunkEnd;
+			return true;
+		}
+	}
+}
+
+bool ThreadPool::StealWork(const unsigned threadIndex)
+{
+	const unsigned threadCount = GetThreadCount();
+
+	for (unsigned offset = 1; offset < threadCount; offset++)
+	{
+		std::atomic<std::uint64_t>& victimRange = m_WorkRanges[(threadIndex + offset) % threadCount].m_Range;
+
+		std::uint64_t current = victimRange.load();
+
+		for (;;)
+		{
+			const int rangeBegin = GetRangeBegin(current);
+			const int rangeEnd = GetRangeEnd(current);
+
+			if (rangeBegin >= rangeEnd) break;
+
+			// Leave the victim the front half, since it's working from the front.
+			const int middle = rangeBegin + (rangeEnd - rangeBegin) / 2;
+
+			if (victimRange.compare_exchange_weak(current, PackRange(rangeBegin, middle))) {
+				// Nobody steals from an empty range, so this can't race with a thief.
+				m_WorkRanges[threadIndex].m_Range = PackRange(middle, rangeEnd);
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void ThreadPool::WorkerMain(const unsigned threadIndex, unsigned lastGeneration)
+{
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+
+			m_JobStarted.wait(lock, [this, lastGeneration]() {
+				return m_Quit || m_JobGeneration != lastGeneration;
+			});
+
+			if (m_Quit) return;
+
+			lastGeneration = m_JobGeneration;
+		}
+
+		RunJob(threadIndex);
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			assert(m_BusyWorkers > 0);
+
+			if (--m_BusyWorkers == 0) {
+				m_JobFinished.notify_one();
+			}
+		}
+	}
+}
+
+void ThreadPool::StopWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Quit = true;
+	}
+
+	m_JobStarted.notify_all();
+
+	for (auto& worker : m_Workers) {
+		worker.join();
+	}
+
+	m_Workers.clear();
+}
+
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace qvr {
+
+// A fixed set of worker threads that cooperate with the calling thread to run
+// ParallelFor jobs. Only one job runs at a time.
+// Each thread starts with an even share of the indices and works through them in order.
+// Threads that run out steal half of what another thread has left.
+class ThreadPool
+{
+public:
+	// A thread count of 0 means "one per hardware thread".
+	explicit ThreadPool(const unsigned threadCount = 1);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool(const ThreadPool&&) = delete;
+
+	ThreadPool& operator=(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&&) = delete;
+
+	// The number of threads that run a job, including the calling thread.
+	unsigned GetThreadCount() const { return m_Workers.size() + 1; }
+
+	// Joins the current workers and spawns new ones. Must not be called during ParallelFor.
+	void SetThreadCount(const unsigned threadCount);
+
+	// Calls func(i) once for every i in [0, count) and returns when they have all finished.
+	// The order in which indices are visited is unspecified.
+	void ParallelFor(const int count, const std::function<void(int)>& func);
+
+	// As above, but func also receives the index of the thread running it, in [0, GetThreadCount()).
+	// Handy for giving each thread its own scratch space.
+	void ParallelForPerThread(const int count, const std::function<void(int, unsigned)>& func);
+
+	static unsigned ResolveThreadCount(const unsigned threadCount);
+
+private:
+	// The indices [begin, end) that a thread has yet to start on, packed into one
+	// atomic so that the owner and thieves can both take from it without locking.
+	struct WorkRange {
+		std::atomic<std::uint64_t> m_Range;
+
+		// Keeps each thread's range off the others' cache lines.
+		char m_Padding[64 - sizeof(std::atomic<std::uint64_t>)];
+	};
+
+	static std::uint64_t PackRange(const int begin, const int end) {
+		return ((std::uint64_t)(std::uint32_t)end << 32) | (std::uint32_t)begin;
+	}
+	static int GetRangeBegin(const std::uint64_t range) { return (int)(std::uint32_t)range; }
+	static int GetRangeEnd(const std::uint64_t range) { return (int)(std::uint32_t)(range >> 32); }
+
+	void WorkerMain(const unsigned threadIndex, unsigned lastGeneration);
+	void RunJob(const unsigned threadIndex);
+	void StopWorkers();
+
+	// Takes up to chunkSize indices from the front of the thread's own range.
+	bool TakeWork(const unsigned threadIndex, const int chunkSize, int& begin, int& end);
+
+	// Takes the back half of another thread's range, and makes it this thread's range.
+	bool StealWork(const unsigned threadIndex);
+
+	std::vector<std::thread> m_Workers;
+
+	std::mutex m_Mutex;
+	std::condition_variable m_JobStarted;
+	std::condition_variable m_JobFinished;
+
+	const std::function<void(int, unsigned)>* m_JobFunc = nullptr;
+	int m_JobCount = 0;
+	unsigned m_JobGeneration = 0;
+	unsigned m_BusyWorkers = 0;
+	bool m_Quit = false;
+
+	// One per thread, including the calling thread.
+	std::unique_ptr<WorkRange[]> m_WorkRanges;
+};
+
+}
@@ -11,6 +11,17 @@ void b2BodyDeleter::operator()(b2Body* body) const {
 	body->GetWorld()->DestroyBody(body);
 }
 
+b2Transform Interpolate(const b2Transform& from, const b2Transform& to, const float alpha)
+{
+	const b2Vec2 position = from.p + alpha * (to.p - from.p);
+
+	// The angle from 'from' to 'to', in [-pi, pi].
+	const b2Rot delta = b2MulT(from.q, to.q);
+	const float angle = from.q.GetAngle() + alpha * delta.GetAngle();
+
+	return b2Transform(position, b2Rot(angle));
+}
+
 }
 
 }
\ No newline at end of file
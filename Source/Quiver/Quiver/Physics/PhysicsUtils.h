@@ -3,6 +3,8 @@
 #include <array>
 #include <memory>
 
+#include <Box2D/Common/b2Math.h>
+
 class b2Body;
 
 namespace qvr {
@@ -19,6 +21,10 @@ using b2BodyUniquePtr = std::unique_ptr<b2Body, b2BodyDeleter>;
 
 static_assert(sizeof(b2BodyUniquePtr) == sizeof(b2Body*), "Oh no!");
 
+// Blends two transforms. The position is lerped and the rotation 
+// turns the short way round, so alpha = 0 gives from and alpha = 1 gives to.
+b2Transform Interpolate(const b2Transform& from, const b2Transform& to, const float alpha);
+
 }
 
 }
\ No newline at end of file
@@ -9,6 +9,7 @@
 
 #include <Box2D/Collision/Shapes/b2PolygonShape.h>
 #include <Box2D/Common/b2Math.h>
+#include <Box2D/Dynamics/b2Body.h>
 #include <Box2D/Dynamics/b2Fixture.h>
 #include <Box2D/Dynamics/b2World.h>
 #include <Box2D/Dynamics/b2WorldCallbacks.h>
@@ -106,6 +107,9 @@ World::World(
 	, mTextureLibrary(std::make_unique<TextureLibrary>())
 {
 	mPhysicsWorld->SetContactListener(mContactListener.get());
+
+	// Animators catch up when their fixtures are drawn, so the ones that are out of sight are cheap.
+	mAnimators.SetLazy(true);
 }
 
 World::~World() {}
@@ -118,6 +122,17 @@ void World::TakeStep(qvr::RawInputDevices& inputDevices)
 
 	ProfilerScope ps(sStepProfiler);
 
+	// Remember where everything was, for rendering in between this step and the next.
+	for (b2Body* body = mPhysicsWorld->GetBodyList(); body != nullptr; body = body->GetNext()) {
+		if (auto physicsComponent = static_cast<PhysicsComponent*>(body->GetUserData())) {
+			physicsComponent->SavePreviousTransform();
+		}
+	}
+
+	for (Camera3D* camera : mCameras) {
+		camera->SavePreviousTransform();
+	}
+
 	// Update physics world.
 	{
 		int velocity_iterations = 8;
@@ -137,10 +152,13 @@ void World::TakeStep(qvr::RawInputDevices& inputDevices)
 	{
 		auto removeFlaggers = m_CustomComponentUpdater.GetRemoveFlaggers();
 		for (auto customComponent : removeFlaggers) {
-			RemoveEntityImmediate(customComponent.get().GetEntity());
+			mCommands.DestroyEntity(customComponent.get().GetEntity().GetId());
 		}
 	}
 
+	// Everything recorded during the step, including by contact callbacks, happens here.
+	ApplyCommands();
+
 	mStepCount += 1;
 }
 
@@ -155,9 +173,9 @@ void World::SetPaused(const bool paused)
 
 	}
 
-	for (auto& audioComponent : mAudioComponents)
+	for (AudioComponent* audioComponent : mAudioComponents)
 	{
-		audioComponent.get().SetPaused(paused);
+		audioComponent->SetPaused(paused);
 	}
 
 	mPaused = paused;
@@ -248,18 +266,123 @@ void World::Render3D(
 	const Camera3D & camera,
 	WorldRaycastRenderer & raycastRenderer)
 {
+	const sf::Vector2u targetSize = target.getSize();
+
+	Render3D(
+		target,
+		{ RaycastRenderView{ &camera, sf::IntRect(0, 0, targetSize.x, targetSize.y) } },
+		raycastRenderer);
+}
+
+void World::Render3D(
+	sf::RenderTarget & target,
+	const std::vector<RaycastRenderView>& views,
+	WorldRaycastRenderer & raycastRenderer)
+{
+	if (views.empty()) return;
+
 	{
 		ProfilerScope ps(sPreRenderProfiler);
 
-		UpdateDetachedRenderComponents(camera);
+		// Detached sprites are only positioned once. With more than one view,
+		// WorldRaycastRenderer always culls, and turns them to face each view's camera itself.
+		UpdateDetachedRenderComponents(*views[0].m_Camera);
+	}
+
+	const sf::Vector2u fullTargetSize = target.getSize();
+
+	if (sColumnsProfiler.BufferSize() != static_cast<int>(fullTargetSize.x)) {
+		sColumnsProfiler.Resize(fullTargetSize.x);
+	}
+
+	const sf::View originalView = target.getView();
+
+	// An sf::View that maps the viewport's own coordinates onto it.
+	const auto GetSfView = [fullTargetSize](const sf::IntRect& viewport)
+	{
+		sf::View view(sf::FloatRect(0.0f, 0.0f, (float)viewport.width, (float)viewport.height));
+		view.setViewport(sf::FloatRect(
+			(float)viewport.left / fullTargetSize.x,
+			(float)viewport.top / fullTargetSize.y,
+			(float)viewport.width / fullTargetSize.x,
+			(float)viewport.height / fullTargetSize.y));
+		return view;
+	};
+
+	for (const RaycastRenderView& view : views)
+	{
+		target.setView(GetSfView(view.m_Viewport));
+
+		RenderBackground(
+			target, 
+			*view.m_Camera, 
+			sf::Vector2u(view.m_Viewport.width, view.m_Viewport.height));
 	}
 
+	target.setView(target.getDefaultView());
+
+	{
+		ProfilerScope ps(sRenderProfiler);
+
+		raycastRenderer.Render(*this, views, mRenderSettings, target);
+	}
+
+	// Render stuff that goes on top of the 3D image (effects, HUD, weapons...)
+	for (unsigned viewIndex = 0; viewIndex < views.size(); viewIndex++)
+	{
+		target.setView(GetSfView(views[viewIndex].m_Viewport));
+
+		views[viewIndex].m_Camera->DrawOverlay(target, raycastRenderer.GetDepthBuffer(viewIndex));
+	}
+
+	target.setView(originalView);
+}
+
+void World::Render3DPipelined(
+	sf::RenderTarget & target,
+	const Camera3D & camera,
+	WorldRaycastRenderer & raycastRenderer)
+{
 	const sf::Vector2u targetSize = target.getSize();
 
-	if (sColumnsProfiler.BufferSize() != static_cast<int>(targetSize.x)) {
-		sColumnsProfiler.Resize(targetSize.x);
+	{
+		ProfilerScope ps(sPreRenderProfiler);
+
+		UpdateDetachedRenderComponents(camera);
+
+		raycastRenderer.CaptureFrame(
+			*this,
+			{ RaycastRenderView{ &camera, sf::IntRect(0, 0, targetSize.x, targetSize.y) } },
+			mRenderSettings);
+	}
+
+	if (raycastRenderer.WaitForCastFrame())
+	{
+		const sf::View originalView = target.getView();
+
+		target.setView(target.getDefaultView());
+
+		RenderBackground(target, raycastRenderer.GetCastCamera(), targetSize);
+
+		{
+			ProfilerScope ps(sRenderProfiler);
+
+			raycastRenderer.DrawCastFrame(target);
+		}
+
+		camera.DrawOverlay(target, raycastRenderer.GetDepthBuffer());
+
+		target.setView(originalView);
 	}
 
+	raycastRenderer.CastFrame();
+}
+
+void World::RenderBackground(
+	sf::RenderTarget& target,
+	const Camera3D& camera,
+	const sf::Vector2u& targetSize)
+{
 	// Draw ground.
 	{
 		sf::RectangleShape rect;
@@ -328,15 +451,6 @@ void World::Render3D(
 
 		mSky.Render(target, camera);
 	}
-
-	{
-		ProfilerScope ps(sRenderProfiler);
-
-		raycastRenderer.Render(*this, camera, mRenderSettings, target);
-	}
-
-	// Render stuff that goes on top of the 3D image (effects, HUD, weapons...)
-	camera.DrawOverlay(target);
 }
 
 bool World::RegisterUiRenderer(WorldUiRenderer& renderer)
@@ -405,26 +519,27 @@ Entity* World::CreateEntity(const nlohmann::json & j, const b2Transform * transf
 
 bool World::RemoveEntityImmediate(const Entity & entity)
 {
-	const auto it = mEntities.find(entity.GetId());
-
-	if (it == mEntities.end()) return false;
-
-	mEntities.erase(it);
+	return mEntities.Remove(entity.GetId().get());
+}
 
-	return true;
+void World::ReserveEntities(const unsigned count)
+{
+	mEntities.Reserve(mEntities.size() + count);
 }
 
 bool World::AddEntity(std::unique_ptr<Entity> entity)
 {
 	assert(entity != nullptr);
 	assert(&entity->GetWorld() == this);
-	assert(mEntities.count(entity->GetId()) == 0);
+	assert(entity->GetId() == EntityId(0));
 
 	if (entity == nullptr) return false;
 	if (&entity->GetWorld() != this) return false;
-	if (mEntities.count(entity->GetId()) != 0) return false;
+	if (entity->GetId() != EntityId(0)) return false;
 
-	mEntities[entity->GetId()] = std::move(entity);
+	Entity& added = *entity;
+
+	added.mId = EntityId(mEntities.Insert(std::move(entity)));
 
 	return true;
 }
@@ -469,7 +584,7 @@ bool World::ToJson(nlohmann::json & j) const {
 
 	for (const auto& entity : mEntities)
 	{
-		json entityData = entity.second->ToJson();
+		json entityData = entity->ToJson();
 		if (entityData.empty()) {
 			log->error("Entity serialization failed.");
 			continue;
@@ -527,7 +642,8 @@ World::World(
 		log->error("Failed to deserialize directional light.");
 	}
 
-	mAnimators = JsonHelp::GetValue<nlohmann::json>(j, animationsFieldName, {});
+	// Into the existing AnimatorCollection, so that it stays lazy.
+	from_json(JsonHelp::GetValue<nlohmann::json>(j, animationsFieldName, {}), mAnimators);
 
 	if (j.find("Prefabs") != j.end()) {
 		if (!mEntityPrefabs.FromJson(j["Prefabs"])) {
@@ -556,41 +672,45 @@ World::World(
 
 bool World::RegisterCamera(const Camera3D& camera)
 {
-	const auto it = FindByAddress(mCameras, camera);
+	Camera3D& registered = const_cast<Camera3D&>(camera);
 
-	if (it != mCameras.end())
+	if (!mCameras.Add(registered))
 	{
 		return false; // Double-registry is an error.
 	}
 
-	mCameras.push_back(const_cast<Camera3D&>(camera));
+	// Otherwise it would appear to fly in from wherever it was last saved.
+	registered.SavePreviousTransform();
 
 	return true;
 }
 
 bool World::UnregisterCamera(const Camera3D& camera)
 {
-	const auto it = FindByAddress(mCameras, camera);
+	Camera3D& registered = const_cast<Camera3D&>(camera);
+
+	const int removedIndex = mCameras.GetIndex(registered);
 
-	if (it != mCameras.end())
+	if (removedIndex < 0)
 	{
-		const auto removedIndex = std::distance(std::cbegin(mCameras), it);
+		return false;
+	}
 
-		if (mMainCameraIndex == removedIndex)
-		{
-			mMainCameraIndex = -1;
-		}
-		else if (mMainCameraIndex > removedIndex)
-		{
-			mMainCameraIndex -= 1;
-		}
+	// The last camera takes the removed one's place.
+	const int lastIndex = mCameras.size() - 1;
 
-		mCameras.erase(it);
+	mCameras.Remove(registered);
 
-		return true;
+	if (mMainCameraIndex == removedIndex)
+	{
+		mMainCameraIndex = -1;
+	}
+	else if (mMainCameraIndex == lastIndex)
+	{
+		mMainCameraIndex = removedIndex;
 	}
 
-	return false;
+	return true;
 }
 
 bool World::SetMainCamera(const Camera3D& camera)
@@ -598,15 +718,15 @@ bool World::SetMainCamera(const Camera3D& camera)
 	auto log = spdlog::get("console");
 	assert(log);
 
-	const auto it = FindByAddress(mCameras, camera);
+	const int index = mCameras.GetIndex(const_cast<Camera3D&>(camera));
 
-	if (it != mCameras.end())
+	if (index >= 0)
 	{
 		log->info("Changing main camera index from {} to {}",
 			mMainCameraIndex,
-			std::distance(std::cbegin(mCameras), it));
+			index);
 
-		mMainCameraIndex = std::distance(std::cbegin(mCameras), it);
+		mMainCameraIndex = index;
 
 		return true;
 	}
@@ -623,7 +743,7 @@ const Camera3D* World::GetMainCamera() const
 		return nullptr;
 	}
 
-	return &(mCameras.at(mMainCameraIndex).get());
+	return mCameras.Get(mMainCameraIndex);
 }
 
 bool World::RegisterDetachedRenderComponent(const RenderComponent& renderComponent)
@@ -635,21 +755,19 @@ bool World::RegisterDetachedRenderComponent(const RenderComponent& renderCompone
 
 	static const char* logCtx = "World::RegisterDetachedRenderComponent:";
 
-	const auto it = FindByAddress(mDetachedRenderComponents, renderComponent);
+	RenderComponent& registered = const_cast<RenderComponent&>(renderComponent);
 
-	if (it != mDetachedRenderComponents.end())
+	if (!mDetachedRenderComponents.Add(registered))
 	{
 		log->warn(
 			"{} Trying to register a RenderComponent (index: {}, address: {:x}) a second time.",
 			logCtx,
-			it - mDetachedRenderComponents.begin(),
+			mDetachedRenderComponents.GetIndex(registered),
 			(uintptr_t)&renderComponent);
 
 		return true;
 	}
 
-	mDetachedRenderComponents.push_back(const_cast<RenderComponent&>(renderComponent));
-
 	log->debug(
 		"{} Registered a RenderComponent (address: {:x}) with index {}. "
 		"There are now {} registered FlatSprites.",
@@ -670,10 +788,7 @@ bool World::UnregisterDetachedRenderComponent(const RenderComponent& renderCompo
 
 	static const char* logCtx = "World::UnregisterDetachedRenderComponent:";
 
-	const auto it = FindByAddress(mDetachedRenderComponents, renderComponent);
-
-	if (it != mDetachedRenderComponents.end()) {
-		mDetachedRenderComponents.erase(it);
+	if (mDetachedRenderComponents.Remove(const_cast<RenderComponent&>(renderComponent))) {
 		return true;
 	}
 
@@ -687,37 +802,23 @@ bool World::UnregisterDetachedRenderComponent(const RenderComponent& renderCompo
 
 void World::UpdateDetachedRenderComponents(const Camera3D& camera)
 {
-	for (auto renderComp : mDetachedRenderComponents) {
-		renderComp.get().UpdateDetachedBodyPosition();
-		renderComp.get().UpdateDetachedBodyRotation(camera.GetRotation());
+	for (RenderComponent* renderComp : mDetachedRenderComponents) {
+		renderComp->UpdateDetachedBodyPosition();
+		renderComp->UpdateDetachedBodyRotation(camera.GetRotation());
 	}
 }
 
 bool World::RegisterAudioComponent(const AudioComponent & audioComponent)
 {
-	const auto it = FindByAddress(mAudioComponents, audioComponent);
-
-	if (it != mAudioComponents.end())
-	{
-		return true;
-	}
-
-	mAudioComponents.push_back(const_cast<AudioComponent&>(audioComponent));
+	// Registering twice is harmless.
+	mAudioComponents.Add(const_cast<AudioComponent&>(audioComponent));
 
 	return true;
 }
 
 bool World::UnregisterAudioComponent(const AudioComponent & audioComponent)
 {
-	const auto it = FindByAddress(mAudioComponents, audioComponent);
-
-	if (it != mAudioComponents.end())
-	{
-		mAudioComponents.erase(it);
-		return true;
-	}
-
-	return false;
+	return mAudioComponents.Remove(const_cast<AudioComponent&>(audioComponent));
 }
 
 
@@ -743,9 +844,9 @@ auto World::GetNextApplicationState(ApplicationStateContext & context)
 
 void World::UpdateAudioComponents()
 {
-	for (auto& audioComponent : mAudioComponents)
+	for (AudioComponent* audioComponent : mAudioComponents)
 	{
-		audioComponent.get().Update();
+		audioComponent->Update();
 	}
 }
 
@@ -800,7 +901,7 @@ void World::GuiControls() {
 
 			auto itemGetter = [](void* data, int index, const char** itemText)
 			{
-				auto cameras = static_cast<std::vector<std::reference_wrapper<Camera3D>>*>(data);
+				auto cameras = static_cast<IndexedRegistry<Camera3D>*>(data);
 
 				if (index < 0) return false;
 				if (index >= (int)cameras->size()) return false;
@@ -819,7 +920,7 @@ void World::GuiControls() {
 				(void*)&mCameras,
 				(int)mCameras.size()))
 			{
-				SetMainCamera(mCameras.at(mainCameraIndex));
+				SetMainCamera(*mCameras.Get(mainCameraIndex));
 			}
 		}
 		else {
@@ -839,6 +940,18 @@ void World::GuiControls() {
 		ImGui::AutoIndent indent;
 
 		ImGui::SliderFloat("Ray Length", &mRenderSettings.m_RayLength, 1.0f, 100.0f);
+
+		ImGui::SliderInt("Threads (0 = Auto)", &mRenderSettings.m_ThreadCount, 0, 16);
+
+		ImGui::Checkbox("Batch Columns", &mRenderSettings.m_BatchColumns);
+
+		ImGui::Checkbox("Frustum Cull", &mRenderSettings.m_FrustumCull);
+
+		ImGui::Checkbox("Reuse Unchanged Columns", &mRenderSettings.m_ReuseColumns);
+
+		ImGui::Checkbox("Texture Atlas", &mRenderSettings.m_TextureAtlas);
+
+		ImGui::Checkbox("Software Rasterizer", &mRenderSettings.m_SoftwareRasterizer);
 	}
 }
 
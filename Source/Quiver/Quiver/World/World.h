@@ -12,12 +12,15 @@
 
 #include "Quiver/Animation/Animators.h"
 #include "Quiver/Entity/CustomComponent/CustomComponentUpdater.h"
+#include "Quiver/Entity/EntityCommandBuffer.h"
 #include "Quiver/Entity/EntityId.h"
 #include "Quiver/Entity/EntityPrefab.h"
 #include "Quiver/Graphics/Fog.h"
 #include "Quiver/Graphics/Light.h"
 #include "Quiver/Graphics/RenderSettings.h"
 #include "Quiver/Graphics/Sky.h"
+#include "Quiver/Misc/IndexedRegistry.h"
+#include "Quiver/Misc/SlotMap.h"
 #include "Quiver/World/WorldContext.h"
 
 struct b2Transform;
@@ -45,6 +48,7 @@ class Entity;
 class EntityPrefab;
 class RawInputDevices;
 class RenderComponent;
+struct RaycastRenderView;
 class TextureLibrary;
 class World;
 class WorldContext;
@@ -90,6 +94,20 @@ public:
 		const Camera3D& camera,
 		WorldRaycastRenderer& raycastRenderer);
 
+	// Draws each view's camera into its viewport, e.g. for split-screen.
+	void Render3D(
+		sf::RenderTarget& target,
+		const std::vector<RaycastRenderView>& views,
+		WorldRaycastRenderer& raycastRenderer);
+
+	// Like Render3D, but the rays are cast on the renderer's render thread while the
+	// caller gets on with other things, like the next step. What gets drawn is the frame
+	// that was captured by the previous call, so the picture is a frame behind.
+	void Render3DPipelined(
+		sf::RenderTarget& target,
+		const Camera3D& camera,
+		WorldRaycastRenderer& raycastRenderer);
+
 	void RenderUI(sf::RenderTarget& target);
 
 	Entity* CreateEntity(const b2Shape & shape, const b2Vec2 & position, const float angle = 0.0f);
@@ -97,18 +115,24 @@ public:
 
 	bool AddEntity(std::unique_ptr<Entity> entity);
 
+	// Null if the Entity has been removed since the id was handed out.
 	Entity* GetEntity(const EntityId id) {
-		if (id == EntityId(0)) return nullptr;
-		
-		const auto it = mEntities.find(id);
-
-		if (it == mEntities.end()) return nullptr;
+		const auto entity = mEntities.Get(id.get());
 
-		return it->second.get();
+		return entity ? entity->get() : nullptr;
 	}
 
 	bool RemoveEntityImmediate(const Entity& entity);
 
+	// Makes room for count more Entities, so that adding them doesn't reallocate.
+	void ReserveEntities(const unsigned count);
+
+	// Changes to Entities that can't be made immediately, like during a step or
+	// a contact callback. TakeStep applies them at the end of each step.
+	EntityCommandBuffer& GetCommands() { return mCommands; }
+
+	void ApplyCommands() { mCommands.Apply(*this); }
+
 	void GuiControls();
 	void GuiPerformanceInfo();
 
@@ -126,6 +150,12 @@ public:
 
 	void UpdateDetachedRenderComponents(const Camera3D& camera);
 
+	// Ground and sky, in the target's current view.
+	void RenderBackground(
+		sf::RenderTarget& target,
+		const Camera3D& camera,
+		const sf::Vector2u& targetSize);
+
 	bool RegisterAudioComponent(const AudioComponent& audioComponent);
 	bool UnregisterAudioComponent(const AudioComponent& audioComponent);
 
@@ -137,19 +167,20 @@ public:
 
 	inline std::chrono::duration<float> GetTimestep() const { return mTimestep; }
 
+	// How far between the last two steps to draw bodies and cameras, from 0 (the 
+	// previous step) to 1 (the latest step). Lets the frame rate differ from the step rate.
+	void SetRenderInterpolation(const float alpha) { mRenderInterpolation = b2Clamp(alpha, 0.0f, 1.0f); }
+	float GetRenderInterpolation() const { return mRenderInterpolation; }
+
 	inline const DirectionalLight& GetDirectionalLight() const { return mDirectionalLight; }
 
 	inline const b2World* GetPhysicsWorld() const { return mPhysicsWorld.get(); }
 
 	AnimatorCollection& GetAnimators() { return mAnimators; }
+	const AnimatorCollection& GetAnimators() const { return mAnimators; }
 	AudioLibrary&    GetAudioLibrary() { return *mAudioLibrary.get(); }
 	TextureLibrary&  GetTextureLibrary() { return *mTextureLibrary.get(); }
-
-	EntityId GetNextEntityId() { 
-		EntityId id = mNextEntityId; 
-		mNextEntityId = EntityId(mNextEntityId.get() + 1);
-		return id;
-	}
+	const TextureLibrary& GetTextureLibrary() const { return *mTextureLibrary.get(); }
 
 	EntityPrefabContainer mEntityPrefabs;
 
@@ -193,14 +224,14 @@ private:
 
 	int mStepCount = 0;
 
+	float mRenderInterpolation = 1.0f;
+
 	bool mPaused = false;
 
 	TimePoint mTotalTime = TimePoint(0.0f);
 
 	int mMainCameraIndex = -1;
 
-	EntityId mNextEntityId = EntityId(1);
-
 	AmbientLight mAmbientLight;
 
 	DirectionalLight mDirectionalLight;
@@ -217,12 +248,15 @@ private:
 	std::unique_ptr<AudioLibrary>      mAudioLibrary;
 	std::unique_ptr<TextureLibrary>    mTextureLibrary;
 
-	std::vector<std::reference_wrapper<Camera3D>>        mCameras;
-	std::vector<std::reference_wrapper<RenderComponent>> mDetachedRenderComponents;
-	std::vector<std::reference_wrapper<AudioComponent>>  mAudioComponents;
-	std::vector<std::reference_wrapper<WorldUiRenderer>>      mUiRenderers;
+	IndexedRegistry<Camera3D>        mCameras;
+	IndexedRegistry<RenderComponent> mDetachedRenderComponents;
+	IndexedRegistry<AudioComponent>  mAudioComponents;
+
+	std::vector<std::reference_wrapper<WorldUiRenderer>> mUiRenderers;
+
+	SlotMap<std::unique_ptr<Entity>> mEntities;
 
-	std::unordered_map<EntityId, std::unique_ptr<Entity>> mEntities;
+	EntityCommandBuffer mCommands;
 
 	CustomComponentUpdater m_CustomComponentUpdater;
 
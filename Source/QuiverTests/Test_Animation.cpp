@@ -1,5 +1,12 @@
 #include <Catch.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
 #include "Quiver/Animation/AnimationData.h"
 #include "Quiver/Animation/Animators.h"
 #include "Quiver/Misc/Logging.h"
@@ -236,13 +243,13 @@ TEST_CASE("AnimatorCollection", "[Animation]")
 	REQUIRE(animatorId != AnimatorId::Invalid);
 	REQUIRE(animators.GetAnimation(animatorId) == animationId);
 	REQUIRE(animators.GetFrame(animatorId) == 0);
-	REQUIRE(animatorTarget.views.views[0] == animationData.GetRect(0).value());
+	REQUIRE(GetView(animatorTarget.views) == animationData.GetRect(0).value());
 
 	SECTION("Animate plays the animation") {
 		for (int i = 0; i < animationData.GetFrameCount(); ++i) {
 			REQUIRE(animators.GetAnimation(animatorId) == animationId);
 			REQUIRE((int)animators.GetFrame(animatorId) == i);
-			REQUIRE(animatorTarget.views.views[0] == animationData.GetRect(i).value());
+			REQUIRE(GetView(animatorTarget.views) == animationData.GetRect(i).value());
 
 			animators.Animate(animationData.GetTime(i).value());
 		}
@@ -250,13 +257,17 @@ TEST_CASE("AnimatorCollection", "[Animation]")
 		SECTION("It loops") {
 			REQUIRE(animators.GetAnimation(animatorId) == animationId);
 			REQUIRE(animators.GetFrame(animatorId) == 0);
-			REQUIRE(animatorTarget.views.views[0] == animationData.GetRect(0).value());
+			REQUIRE(GetView(animatorTarget.views) == animationData.GetRect(0).value());
 		}
 	}
 
 	SECTION("RemoveAnimation removes the animation and the animator that references it") {
 		REQUIRE(animators.RemoveAnimation(animationId));
 		REQUIRE(animators.Exists(animatorId) == false);
+
+		// The target keeps a copy of the frame it was showing.
+		REQUIRE(GetView(animatorTarget.views) == animationData.GetRect(0).value());
+		REQUIRE(animatorTarget.views.views == nullptr);
 	}
 
 	SECTION("Remove removes the animator but keeps the animation") {
@@ -272,7 +283,7 @@ TEST_CASE("AnimatorCollection", "[Animation]")
 			}
 		}
 
-		const Rect originalTargetVal = animatorTarget.views.views[0];
+		const Rect originalTargetVal = GetView(animatorTarget.views);
 		const int originalFrame = animators.GetFrame(animatorId);
 
 		SECTION("Reject invalid frame") {
@@ -280,14 +291,14 @@ TEST_CASE("AnimatorCollection", "[Animation]")
 			{
 				REQUIRE(animators.SetFrame(animatorId, invalidFrame) == false);
 				REQUIRE((int)animators.GetFrame(animatorId) == originalFrame);
-				REQUIRE(animatorTarget.views.views[0] == originalTargetVal);
+				REQUIRE(GetView(animatorTarget.views) == originalTargetVal);
 			}
 		}
 
 		SECTION("Set to current frame") {
 			REQUIRE(animators.SetFrame(animatorId, 0));
 			REQUIRE((int)animators.GetFrame(animatorId) == originalFrame);
-			REQUIRE(animatorTarget.views.views[0] == originalTargetVal);
+			REQUIRE(GetView(animatorTarget.views) == originalTargetVal);
 		}
 
 		SECTION("Set to other frame") {
@@ -295,7 +306,7 @@ TEST_CASE("AnimatorCollection", "[Animation]")
 
 			REQUIRE(animators.SetFrame(animatorId, otherIndex));
 			REQUIRE(animators.GetFrame(animatorId) == otherIndex);
-			REQUIRE(animatorTarget.views.views[0] == animationData.GetRect(otherIndex).value());
+			REQUIRE(GetView(animatorTarget.views) == animationData.GetRect(otherIndex).value());
 		}
 	}
 
@@ -306,14 +317,14 @@ TEST_CASE("AnimatorCollection", "[Animation]")
 
 		SECTION("SetAnimation works with the current animation") {
 			const int currentFrame = animators.GetFrame(animatorId);
-			const Rect currentRect = animatorTarget.views.views[0];
+			const Rect currentRect = GetView(animatorTarget.views);
 
 			REQUIRE(animators.SetAnimation(animatorId, animationId));
 			
 			// Check that the animator & target are left unchanged
 			REQUIRE(animators.GetAnimation(animatorId) == animationId);
 			REQUIRE((int)animators.GetFrame(animatorId) == currentFrame);
-			REQUIRE(currentRect == animatorTarget.views.views[0]);
+			REQUIRE(currentRect == GetView(animatorTarget.views));
 		}
 
 		SECTION("SetAnimation works with different animation") {
@@ -359,6 +370,280 @@ TEST_CASE("AnimatorCollection", "[Animation]")
 	SECTION("QueueAnimation") {
 
 	}
+
+	SECTION("Targets point at the AnimationLibrary's rects, which don't move") {
+		const Rect* const rects = GetViews(animatorTarget.views).data();
+
+		REQUIRE(rects == animators.GetAnimations().GetRects(animationId, 0).data());
+
+		// Enough to need more storage.
+		for (int i = 0; i < 2000; i++) {
+			AnimationData other;
+			other.AddFrame(Frame{ 10ms, Rect{ i, 0, i + 1, 1 },{} });
+			other.AddFrame(Frame{ 10ms, Rect{ i, 1, i + 1, 2 },{} });
+			REQUIRE(animators.AddAnimation(other) != AnimationId::Invalid);
+		}
+
+		REQUIRE(GetViews(animatorTarget.views).data() == rects);
+		REQUIRE(GetView(animatorTarget.views) == animationData.GetRect(0).value());
+	}
+
+	SECTION("Removing an Animator leaves the others alone") {
+		AnimatorTarget otherTarget{};
+		const AnimatorId otherId = animators.Add(otherTarget, animationId);
+
+		REQUIRE(animators.SetFrame(otherId, 1));
+		REQUIRE(animators.Remove(animatorId));
+
+		REQUIRE(animators.Exists(animatorId) == false);
+		REQUIRE(animators.Exists(otherId));
+		REQUIRE(animators.GetFrame(otherId) == 1);
+
+		animators.Animate(animationData.GetTime(1).value());
+
+		REQUIRE(animators.GetFrame(otherId) == 0);
+		REQUIRE(GetView(otherTarget.views) == animationData.GetRect(0).value());
+
+		SECTION("A removed Animator's id stays invalid after its slot is reused") {
+			AnimatorTarget newTarget{};
+			const AnimatorId newId = animators.Add(newTarget, animationId);
+
+			REQUIRE(newId != animatorId);
+			REQUIRE(animators.Exists(animatorId) == false);
+			REQUIRE(animators.SetFrame(animatorId, 0) == false);
+			REQUIRE(animators.GetCount() == 2);
+		}
+	}
+}
+
+TEST_CASE("Lazy Animators animate just like eager ones", "[Animation]")
+{
+	qvr::InitLoggers(spdlog::level::off);
+
+	AnimatorCollection eager;
+	AnimatorCollection lazy;
+	lazy.SetLazy(true);
+
+	std::mt19937 random(4321);
+
+	std::vector<AnimationId> animationIds;
+
+	for (int i = 0; i < 4; i++) {
+		AnimationData animationData;
+
+		const int frameCount = 2 + i;
+
+		for (int frame = 0; frame < frameCount; frame++) {
+			// Frames that outlast every step let the lazy Animators skip whole loops.
+			const auto time = Animation::TimeUnit((i < 2 ? 5 : 40) + (random() % 150));
+			animationData.AddFrame(Frame{ time, Rect{ i, frame, i + 1, frame + 1 },{} });
+		}
+
+		animationIds.push_back(eager.AddAnimation(animationData));
+		lazy.AddAnimation(animationData);
+	}
+
+	const AnimatorRepeatSetting repeatSettings[] = {
+		AnimatorRepeatSetting::Forever,
+		AnimatorRepeatSetting::Never,
+		AnimatorRepeatSetting::Once,
+		AnimatorRepeatSetting::Twice
+	};
+
+	auto randomStartSetting = [&]() {
+		return AnimatorStartSetting(
+			animationIds[random() % animationIds.size()],
+			repeatSettings[random() % 4]);
+	};
+
+	// Finished lazy Animators are only removed once they catch up, so
+	// slots get reused in a different order, and the ids can differ.
+	struct Pair {
+		AnimatorId m_EagerId = AnimatorId::Invalid;
+		AnimatorId m_LazyId = AnimatorId::Invalid;
+		std::unique_ptr<AnimatorTarget> m_EagerTarget;
+		std::unique_ptr<AnimatorTarget> m_LazyTarget;
+	};
+
+	std::vector<Pair> pairs;
+
+	auto addPair = [&](const AnimatorStartSetting& startSetting) {
+		Pair pair;
+		pair.m_EagerTarget = std::make_unique<AnimatorTarget>();
+		pair.m_LazyTarget = std::make_unique<AnimatorTarget>();
+
+		pair.m_EagerId = eager.Add(*pair.m_EagerTarget, startSetting);
+		pair.m_LazyId = lazy.Add(*pair.m_LazyTarget, startSetting);
+
+		pairs.push_back(std::move(pair));
+	};
+
+	// Enough Animators that each one is only caught up every few hundred steps.
+	for (int i = 0; i < 2000; i++) {
+		addPair(AnimatorStartSetting(
+			animationIds[random() % animationIds.size()],
+			AnimatorRepeatSetting::Forever));
+	}
+
+	// Long enough for the lazy collection to rebase its step log many times.
+	for (int step = 0; step < 6000; step++) {
+		switch (random() % 8) {
+		case 0:
+			addPair(randomStartSetting());
+			break;
+		case 1:
+			if (!pairs.empty()) {
+				const Pair& pair = pairs[random() % pairs.size()];
+				REQUIRE(eager.Remove(pair.m_EagerId) == lazy.Remove(pair.m_LazyId));
+			}
+			break;
+		case 2:
+			if (!pairs.empty()) {
+				const Pair& pair = pairs[random() % pairs.size()];
+				const AnimatorStartSetting startSetting = randomStartSetting();
+				const bool clearQueue = random() % 2 == 0;
+				REQUIRE(
+					eager.SetAnimation(pair.m_EagerId, startSetting, clearQueue)
+					== lazy.SetAnimation(pair.m_LazyId, startSetting, clearQueue));
+			}
+			break;
+		case 3:
+			if (!pairs.empty()) {
+				const Pair& pair = pairs[random() % pairs.size()];
+				const AnimatorStartSetting startSetting = randomStartSetting();
+				REQUIRE(
+					eager.QueueAnimation(pair.m_EagerId, startSetting)
+					== lazy.QueueAnimation(pair.m_LazyId, startSetting));
+			}
+			break;
+		case 4:
+			if (!pairs.empty()) {
+				const Pair& pair = pairs[random() % pairs.size()];
+
+				// As the renderer would, on the odd fixture that comes into view.
+				lazy.UpdateTarget(*pair.m_LazyTarget);
+
+				REQUIRE(GetView(pair.m_EagerTarget->views) == GetView(pair.m_LazyTarget->views));
+			}
+			break;
+		default:
+		{
+			// Sometimes nothing, sometimes long enough to skip frames.
+			const auto time = Animation::TimeUnit(random() % 20 == 0 ? random() % 500 : random() % 40);
+			eager.Animate(time);
+			lazy.Animate(time);
+			break;
+		}
+		}
+
+		// Only now and again, so that the lazy Animators have to catch up on a lot at once.
+		if (step % 100 != 99) continue;
+
+		// Targets first, before anything else makes the Animators catch up.
+		for (const Pair& pair : pairs) {
+			lazy.UpdateTarget(*pair.m_LazyTarget);
+			REQUIRE(GetView(pair.m_EagerTarget->views) == GetView(pair.m_LazyTarget->views));
+		}
+
+		REQUIRE(eager.GetCount() == lazy.GetCount());
+
+		for (const Pair& pair : pairs) {
+			REQUIRE(eager.Exists(pair.m_EagerId) == lazy.Exists(pair.m_LazyId));
+
+			if (!eager.Exists(pair.m_EagerId)) continue;
+
+			REQUIRE(eager.GetAnimation(pair.m_EagerId) == lazy.GetAnimation(pair.m_LazyId));
+			REQUIRE(eager.GetFrame(pair.m_EagerId) == lazy.GetFrame(pair.m_LazyId));
+		}
+
+		for (const AnimationId animation : animationIds) {
+			REQUIRE(eager.GetReferenceCount(animation) == lazy.GetReferenceCount(animation));
+		}
+
+		// Switching back and forth doesn't change anything either.
+		if (step % 1000 == 499) {
+			lazy.SetLazy(false);
+			eager.SetLazy(true);
+			std::swap(eager, lazy);
+
+			for (Pair& pair : pairs) {
+				std::swap(pair.m_EagerId, pair.m_LazyId);
+				std::swap(pair.m_EagerTarget, pair.m_LazyTarget);
+			}
+		}
+	}
+}
+
+TEST_CASE("Benchmark: AnimatorCollection::Animate", "[.][Benchmark][Animation]")
+{
+	using namespace std::chrono;
+	using Clock = high_resolution_clock;
+
+	qvr::InitLoggers(spdlog::level::off);
+
+	const int Steps = 1000;
+
+	// frameTime is roughly how long each frame is held for.
+	auto run = [](const int count, const bool lazy, const Animation::TimeUnit frameTime) {
+		AnimationData animationData;
+		animationData.AddFrame(Frame{ frameTime, Rect{ 0,0,1,1 },{} });
+		animationData.AddFrame(Frame{ frameTime + (frameTime / 2), Rect{ 1,0,2,1 },{} });
+		animationData.AddFrame(Frame{ frameTime * 2, Rect{ 2,0,3,1 },{} });
+
+		AnimatorCollection animators;
+		animators.SetLazy(lazy);
+
+		const AnimationId animationId = animators.AddAnimation(animationData);
+
+		std::vector<std::unique_ptr<AnimatorTarget>> targets;
+
+		for (int i = 0; i < count; i++) {
+			targets.push_back(std::make_unique<AnimatorTarget>());
+			animators.Add(*targets.back(), animationId);
+
+			// Spread the frame changes out.
+			animators.Animate(Animation::TimeUnit(i % 7));
+		}
+
+		Clock::duration total = Clock::duration::zero();
+		Clock::duration longest = Clock::duration::zero();
+
+		for (int i = 0; i < Steps; i++) {
+			const auto start = Clock::now();
+
+			animators.Animate(16ms);
+
+			const auto time = Clock::now() - start;
+			total += time;
+			longest = std::max(longest, time);
+		}
+
+		// As if every one of them came into view at once.
+		const auto start = Clock::now();
+
+		for (const auto& target : targets) {
+			animators.UpdateTarget(*target);
+		}
+
+		const auto updateTargets = Clock::now() - start;
+
+		std::cout
+			<< count << " animators, "
+			<< frameTime.count() << "ms frames, "
+			<< (lazy ? "lazy" : "counted down") << ": "
+			<< duration_cast<microseconds>(total).count() / Steps << "us per step, "
+			<< duration_cast<microseconds>(longest).count() << "us at most, "
+			<< duration_cast<microseconds>(updateTargets).count() << "us to update every target\n";
+
+		REQUIRE(animators.GetCount() == count);
+	};
+
+	for (const int count : { 1000, 10000, 100000 }) {
+		for (const auto frameTime : { 100ms, 1000ms, 10000ms }) {
+			run(count, false, frameTime);
+			run(count, true, frameTime);
+		}
+	}
 }
 
 TEST_CASE("AnimationLibrary", "[Animation]") {
@@ -419,4 +704,60 @@ TEST_CASE("AnimationLibrary", "[Animation]") {
 	REQUIRE(animations.GetRect(animationId2, 0) == animationData.GetRect(0).value());
 	REQUIRE(animations.GetRect(animationId2, 1) == animationData.GetRect(1).value());
 	REQUIRE(animations.GetRect(animationId2, 2) == animationData.GetRect(2).value());
-}
\ No newline at end of file
+}
+
+TEST_CASE("Removed animations' rects are reused", "[Animation]") {
+	qvr::InitLoggers(spdlog::level::off);
+
+	// A different animation each time, like the ones the AnimationEditor previews.
+	auto makeAnimation = [](const int i) {
+		AnimationData animationData;
+		for (int frame = 0; frame < 2 + i % 50; frame++) {
+			animationData.AddFrame(Frame{ 10ms, Rect{ i, frame, i + 1, frame + 1 },{} });
+		}
+		return animationData;
+	};
+
+	SECTION("AnimationLibrary") {
+		AnimationLibrary animations;
+
+		const AnimationData keptData = makeAnimation(5000);
+		const AnimationId kept = animations.Add(keptData);
+
+		const AnimationId first = animations.Add(makeAnimation(0));
+		REQUIRE(animations.Remove(first));
+
+		const int capacity = animations.GetRectCapacity();
+
+		for (int i = 1; i < 5000; i++) {
+			const AnimationId id = animations.Add(makeAnimation(i));
+			REQUIRE(id != AnimationId::Invalid);
+			REQUIRE(animations.Remove(id));
+		}
+
+		REQUIRE(animations.GetRectCapacity() == capacity);
+		REQUIRE(animations.GetRect(kept, 0) == keptData.GetRect(0).value());
+	}
+
+	SECTION("AnimatorCollection") {
+		AnimatorCollection animators;
+		AnimatorTarget target;
+
+		AnimationId id = animators.AddAnimation(makeAnimation(0));
+		animators.Add(target, id);
+
+		const int capacity = animators.GetAnimations().GetRectCapacity();
+
+		for (int i = 1; i < 5000; i++) {
+			REQUIRE(animators.RemoveAnimation(id));
+
+			// The target keeps its own copy of the frame it was showing.
+			REQUIRE(GetView(target.views) == makeAnimation(i - 1).GetRect(0).value());
+
+			id = animators.AddAnimation(makeAnimation(i));
+			REQUIRE(animators.Add(target, id) != AnimatorId::Invalid);
+		}
+
+		REQUIRE(animators.GetAnimations().GetRectCapacity() == capacity);
+	}
+}
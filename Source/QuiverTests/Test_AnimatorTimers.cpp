@@ -0,0 +1,122 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Quiver/Animation/AnimatorTimers.h"
+
+using namespace qvr;
+using namespace qvr::Animation;
+
+TEST_CASE("AdvanceTimers", "[Animation]")
+{
+	for (const bool useSimd : { false, true }) {
+		if (useSimd && !IsTimerSimdAvailable()) continue;
+
+		SECTION(useSimd ? "SIMD" : "Scalar") {
+			// Long enough for both the vector loop and the leftovers.
+			std::vector<TimeUnit::rep> timers = { 5, 10, 15, 10, 30, 1, 100, 10, 9, 11, 0, 10, -3 };
+			std::vector<int> expired(timers.size());
+
+			const int expiredCount = AdvanceTimers(timers, 10, expired, useSimd);
+
+			REQUIRE(timers == std::vector<TimeUnit::rep>({ -5, 0, 5, 0, 20, -9, 90, 0, -1, 1, -10, 0, -13 }));
+			REQUIRE(
+				std::vector<int>(expired.begin(), expired.begin() + expiredCount)
+				== std::vector<int>({ 0, 1, 3, 5, 7, 8, 10, 11, 12 }));
+
+			SECTION("Nothing has to run out") {
+				std::vector<TimeUnit::rep> running(9, 10);
+				REQUIRE(AdvanceTimers(running, 9, expired, useSimd) == 0);
+				REQUIRE(running == std::vector<TimeUnit::rep>(9, 1));
+			}
+
+			SECTION("No timers") {
+				std::vector<TimeUnit::rep> none;
+				REQUIRE(AdvanceTimers(none, 9, expired, useSimd) == 0);
+			}
+		}
+	}
+}
+
+TEST_CASE("AdvanceTimers SIMD and scalar paths agree", "[Animation]")
+{
+	if (!IsTimerSimdAvailable()) return;
+
+	std::mt19937 random(1234);
+	std::uniform_int_distribution<TimeUnit::rep> frameTime(1, 200);
+
+	std::vector<TimeUnit::rep> simd(1003);
+
+	for (auto& timer : simd) {
+		timer = frameTime(random);
+	}
+
+	std::vector<TimeUnit::rep> scalar = simd;
+
+	std::vector<int> simdExpired(simd.size());
+	std::vector<int> scalarExpired(scalar.size());
+
+	for (int step = 0; step < 20; step++) {
+		const int simdCount = AdvanceTimers(simd, 16, simdExpired, true);
+		const int scalarCount = AdvanceTimers(scalar, 16, scalarExpired, false);
+
+		REQUIRE(simd == scalar);
+		REQUIRE(simdCount == scalarCount);
+		REQUIRE(std::equal(simdExpired.begin(), simdExpired.begin() + simdCount, scalarExpired.begin()));
+
+		for (int i = 0; i < simdCount; i++) {
+			simd[simdExpired[i]] += frameTime(random);
+			scalar[scalarExpired[i]] = simd[simdExpired[i]];
+		}
+	}
+}
+
+TEST_CASE("Benchmark: AdvanceTimers", "[.][Benchmark][Animation]")
+{
+	using namespace std::chrono;
+	using Clock = high_resolution_clock;
+
+	const int Steps = 1000;
+
+	for (const int count : { 1000, 10000, 100000 }) {
+		for (const bool useSimd : { false, true }) {
+			if (useSimd && !IsTimerSimdAvailable()) continue;
+
+			std::mt19937 random(1234);
+			std::uniform_int_distribution<TimeUnit::rep> frameTime(30, 200);
+
+			std::vector<TimeUnit::rep> timers(count);
+
+			for (auto& timer : timers) {
+				timer = frameTime(random);
+			}
+
+			std::vector<int> expired(count);
+
+			long long expiredTotal = 0;
+
+			const auto start = Clock::now();
+
+			for (int step = 0; step < Steps; step++) {
+				const int expiredCount = AdvanceTimers(timers, 16, expired, useSimd);
+
+				for (int i = 0; i < expiredCount; i++) {
+					timers[expired[i]] += 100;
+				}
+
+				expiredTotal += expiredCount;
+			}
+
+			const auto end = Clock::now();
+
+			std::cout
+				<< count << " timers, " << (useSimd ? "SIMD" : "scalar") << ": "
+				<< duration_cast<nanoseconds>(end - start).count() / Steps << "ns per step, "
+				<< expiredTotal / Steps << " expired per step\n";
+		}
+	}
+}
@@ -0,0 +1,131 @@
+#include <catch.hpp>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <Box2D/Collision/Shapes/b2CircleShape.h>
+
+#include "Quiver/Entity/Entity.h"
+#include "Quiver/Entity/CustomComponent/CustomComponent.h"
+#include "Quiver/Input/Joystick.h"
+#include "Quiver/Input/JoystickProvider.h"
+#include "Quiver/Input/Keyboard.h"
+#include "Quiver/Input/Mouse.h"
+#include "Quiver/Input/RawInput.h"
+#include "Quiver/World/World.h"
+
+using namespace qvr;
+
+namespace {
+
+class NoKeyboard : public Keyboard {
+public:
+	bool IsDown(const KeyboardKey) const override { return false; }
+	bool JustDown(const KeyboardKey) const override { return false; }
+	bool JustUp(const KeyboardKey) const override { return false; }
+};
+
+class NoJoysticks : public JoystickProvider {
+public:
+	const Joystick* GetJoystick(const JoystickIndex) const override { return nullptr; }
+};
+
+class StepCounter : public CustomComponent {
+public:
+	StepCounter(Entity& entity, const bool selfDestruct)
+		: CustomComponent(entity)
+		, m_SelfDestruct(selfDestruct)
+	{}
+
+	void OnStep(const std::chrono::duration<float>) override {
+		m_StepCount++;
+		m_StepThread = std::this_thread::get_id();
+
+		if (m_SelfDestruct) {
+			GetEntity().GetWorld().GetCommands().DestroyEntity(GetEntity().GetId());
+		}
+	}
+
+	std::string GetTypeName() const override { return "StepCounter"; }
+
+	int m_StepCount = 0;
+	std::thread::id m_StepThread;
+
+private:
+	bool m_SelfDestruct;
+};
+
+}
+
+TEST_CASE("CustomComponentUpdater steps concurrent and serial components", "[Entity]")
+{
+	CustomComponentTypeLibrary types;
+
+	types.RegisterType(
+		std::make_unique<CustomComponentType>(
+			"Concurrent",
+			[](Entity& entity) { return std::make_unique<StepCounter>(entity, false); },
+			true));
+
+	types.RegisterType(
+		std::make_unique<CustomComponentType>(
+			"SelfDestructing",
+			[](Entity& entity) { return std::make_unique<StepCounter>(entity, true); },
+			true));
+
+	types.RegisterType(
+		std::make_unique<CustomComponentType>(
+			"Serial",
+			[](Entity& entity) { return std::make_unique<StepCounter>(entity, false); }));
+
+	FixtureFilterBitNames filterBitNames;
+
+	WorldContext worldContext(types, filterBitNames);
+
+	World world(worldContext);
+
+	Mouse mouse;
+	NoKeyboard keyboard;
+	NoJoysticks joysticks;
+
+	RawInputDevices inputDevices(mouse, keyboard, joysticks);
+
+	auto addComponent = [&world, &types](const char* typeName) {
+		Entity* entity = world.CreateEntity(b2CircleShape(), b2Vec2_zero);
+		entity->AddCustomComponent(types.GetType(typeName)->CreateInstance(*entity));
+		return entity;
+	};
+
+	std::vector<Entity*> concurrent;
+	std::vector<Entity*> serial;
+
+	for (int i = 0; i < 64; i++) {
+		concurrent.push_back(addComponent("Concurrent"));
+	}
+
+	for (int i = 0; i < 4; i++) {
+		serial.push_back(addComponent("Serial"));
+	}
+
+	const EntityId selfDestructing = addComponent("SelfDestructing")->GetId();
+
+	REQUIRE(concurrent.front()->GetCustomComponent()->IsStepConcurrent());
+	REQUIRE(!serial.front()->GetCustomComponent()->IsStepConcurrent());
+
+	world.TakeStep(inputDevices);
+
+	for (Entity* entity : concurrent) {
+		REQUIRE(static_cast<StepCounter*>(entity->GetCustomComponent())->m_StepCount == 1);
+	}
+
+	for (Entity* entity : serial) {
+		const auto counter = static_cast<StepCounter*>(entity->GetCustomComponent());
+
+		REQUIRE(counter->m_StepCount == 1);
+		REQUIRE(counter->m_StepThread == std::this_thread::get_id());
+	}
+
+	REQUIRE(world.GetEntity(selfDestructing) == nullptr);
+}
@@ -0,0 +1,109 @@
+#include <catch.hpp>
+
+#include "Quiver/Graphics/DynamicResolution.h"
+
+using namespace qvr;
+
+namespace {
+
+void AddSamples(DynamicResolution& dynamicResolution, const float milliseconds, const unsigned count) {
+	for (unsigned i = 0; i < count; i++) {
+		dynamicResolution.AddSample(Profiler::SampleUnit(milliseconds));
+	}
+}
+
+}
+
+TEST_CASE("DynamicResolution", "[Graphics]") {
+	DynamicResolutionSettings settings;
+	settings.enabled = true;
+	settings.targetFrameTime = 10.0f;
+	settings.minRatio = 0.25f;
+	settings.maxRatio = 1.0f;
+	settings.hysteresis = 0.2f;
+	settings.maxStep = 0.1f;
+	settings.sampleCount = 10;
+
+	DynamicResolution dynamicResolution(settings);
+
+	float ratio = 1.0f;
+
+	SECTION("Does nothing when disabled") {
+		settings.enabled = false;
+		dynamicResolution.SetSettings(settings);
+
+		AddSamples(dynamicResolution, 40.0f, 10);
+
+		REQUIRE(!dynamicResolution.Update(ratio));
+		REQUIRE(ratio == 1.0f);
+	}
+
+	SECTION("Waits for a full set of samples") {
+		AddSamples(dynamicResolution, 40.0f, 9);
+
+		REQUIRE(!dynamicResolution.Update(ratio));
+
+		AddSamples(dynamicResolution, 40.0f, 1);
+
+		REQUIRE(dynamicResolution.Update(ratio));
+		REQUIRE(ratio < 1.0f);
+	}
+
+	SECTION("Reduces resolution a step at a time, down to the minimum") {
+		float previousRatio = ratio;
+
+		for (int i = 0; i < 20; i++) {
+			AddSamples(dynamicResolution, 40.0f, 10);
+
+			if (dynamicResolution.Update(ratio)) {
+				REQUIRE(ratio < previousRatio);
+				REQUIRE(previousRatio - ratio <= settings.maxStep + 0.0001f);
+			}
+
+			// Nothing new until the buffer has been refilled.
+			REQUIRE(!dynamicResolution.Update(ratio));
+
+			previousRatio = ratio;
+		}
+
+		REQUIRE(ratio == settings.minRatio);
+	}
+
+	SECTION("Increases resolution up to the maximum") {
+		ratio = 0.5f;
+
+		for (int i = 0; i < 20; i++) {
+			AddSamples(dynamicResolution, 1.0f, 10);
+			dynamicResolution.Update(ratio);
+		}
+
+		REQUIRE(ratio == settings.maxRatio);
+	}
+
+	SECTION("Leaves frame times within the hysteresis band alone") {
+		ratio = 0.5f;
+
+		AddSamples(dynamicResolution, 11.5f, 10);
+		REQUIRE(!dynamicResolution.Update(ratio));
+
+		AddSamples(dynamicResolution, 8.5f, 10);
+		REQUIRE(!dynamicResolution.Update(ratio));
+
+		REQUIRE(ratio == 0.5f);
+	}
+
+	SECTION("Settles near the target") {
+		// Pretend render time is proportional to pixel count.
+		const float fullResolutionTime = 40.0f;
+
+		for (int i = 0; i < 50; i++) {
+			AddSamples(dynamicResolution, fullResolutionTime * ratio * ratio, 10);
+			dynamicResolution.Update(ratio);
+		}
+
+		const float frameTime = fullResolutionTime * ratio * ratio;
+
+		REQUIRE(frameTime <= settings.targetFrameTime * (1.0f + settings.hysteresis));
+		REQUIRE(frameTime >= settings.targetFrameTime * (1.0f - settings.hysteresis));
+	}
+}
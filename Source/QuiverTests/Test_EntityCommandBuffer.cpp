@@ -0,0 +1,131 @@
+#include <catch.hpp>
+
+#include <memory>
+
+#include <Box2D/Collision/Shapes/b2CircleShape.h>
+#include <Box2D/Dynamics/b2World.h>
+
+#include "Quiver/Entity/Entity.h"
+#include "Quiver/Entity/EntityCommandBuffer.h"
+#include "Quiver/Entity/CustomComponent/CustomComponent.h"
+#include "Quiver/Entity/PhysicsComponent/PhysicsComponent.h"
+#include "Quiver/World/World.h"
+
+using namespace qvr;
+
+namespace {
+
+class TestComponent : public CustomComponent {
+public:
+	using CustomComponent::CustomComponent;
+
+	std::string GetTypeName() const override { return "TestComponent"; }
+};
+
+}
+
+TEST_CASE("EntityCommandBuffer", "[Entity]")
+{
+	CustomComponentTypeLibrary types;
+	FixtureFilterBitNames filterBitNames;
+
+	WorldContext worldContext(types, filterBitNames);
+
+	World world(worldContext);
+
+	Entity* const existing = world.CreateEntity(b2CircleShape(), b2Vec2_zero);
+	const EntityId existingId = existing->GetId();
+
+	const nlohmann::json entityJson = existing->ToJson();
+
+	EntityCommandBuffer& commands = world.GetCommands();
+
+	REQUIRE(commands.empty());
+
+	SECTION("Nothing happens until the commands are applied") {
+		commands.CreateEntity(entityJson);
+		commands.DestroyEntity(existingId);
+
+		REQUIRE(!commands.empty());
+		REQUIRE(world.GetPhysicsWorld()->GetBodyCount() == 1);
+		REQUIRE(world.GetEntity(existingId) == existing);
+
+		world.ApplyCommands();
+
+		REQUIRE(commands.empty());
+		REQUIRE(world.GetPhysicsWorld()->GetBodyCount() == 1);
+		REQUIRE(world.GetEntity(existingId) == nullptr);
+	}
+
+	SECTION("Created Entities are handed to their callbacks") {
+		const b2Transform transform(b2Vec2(3.0f, 4.0f), b2Rot(0.0f));
+
+		EntityId createdId(0);
+
+		for (int i = 0; i < 10; i++) {
+			commands.CreateEntity(entityJson, &transform, [&createdId](Entity& entity) {
+				createdId = entity.GetId();
+			});
+		}
+
+		world.ApplyCommands();
+
+		REQUIRE(world.GetPhysicsWorld()->GetBodyCount() == 11);
+
+		Entity* const created = world.GetEntity(createdId);
+		REQUIRE(created != nullptr);
+		REQUIRE(created->GetPhysics()->GetPosition().x == 3.0f);
+		REQUIRE(created->GetPhysics()->GetPosition().y == 4.0f);
+	}
+
+	SECTION("Destroying an Entity twice is harmless") {
+		commands.DestroyEntity(existingId);
+		commands.DestroyEntity(existingId);
+
+		world.ApplyCommands();
+
+		REQUIRE(world.GetPhysicsWorld()->GetBodyCount() == 0);
+	}
+
+	SECTION("Component changes to destroyed Entities are ignored") {
+		commands.DestroyEntity(existingId);
+		commands.AddGraphics(existingId, nlohmann::json::object());
+		commands.RemoveCustomComponent(existingId);
+
+		world.ApplyCommands();
+
+		REQUIRE(world.GetEntity(existingId) == nullptr);
+	}
+
+	SECTION("Components can be added and removed") {
+		commands.AddCustomComponent(existingId, [](Entity& entity) {
+			return std::make_unique<TestComponent>(entity);
+		});
+
+		world.ApplyCommands();
+
+		REQUIRE(existing->GetCustomComponent() != nullptr);
+
+		commands.RemoveCustomComponent(existingId);
+		commands.RemoveCustomComponent(existingId);
+
+		world.ApplyCommands();
+
+		REQUIRE(existing->GetCustomComponent() == nullptr);
+	}
+
+	SECTION("Commands recorded while applying wait until next time") {
+		commands.CreateEntity(entityJson, nullptr, [&commands](Entity& entity) {
+			commands.DestroyEntity(entity.GetId());
+		});
+
+		world.ApplyCommands();
+
+		REQUIRE(world.GetPhysicsWorld()->GetBodyCount() == 2);
+		REQUIRE(!commands.empty());
+
+		world.ApplyCommands();
+
+		REQUIRE(world.GetPhysicsWorld()->GetBodyCount() == 1);
+	}
+}
@@ -0,0 +1,150 @@
+#include <catch.hpp>
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include "Quiver/Misc/FindByAddress.h"
+#include "Quiver/Misc/IndexedRegistry.h"
+
+using namespace qvr;
+
+namespace {
+
+struct Registrable {
+	int m_Value = 0;
+	RegistryIndex m_RegistryIndex;
+
+	RegistryIndex& GetRegistryIndex() { return m_RegistryIndex; }
+};
+
+int Sum(const IndexedRegistry<Registrable>& registry) {
+	int sum = 0;
+	for (const Registrable* item : registry) {
+		if (item) sum += item->m_Value;
+	}
+	return sum;
+}
+
+}
+
+TEST_CASE("IndexedRegistry", "[Misc]")
+{
+	std::vector<Registrable> items(5);
+	for (int i = 0; i < 5; i++) items[i].m_Value = 1 << i;
+
+	IndexedRegistry<Registrable> registry;
+
+	for (auto& item : items) {
+		REQUIRE(registry.Add(item));
+	}
+
+	REQUIRE(registry.size() == 5);
+	REQUIRE(Sum(registry) == 31);
+
+	SECTION("Adding twice fails") {
+		REQUIRE(!registry.Add(items[0]));
+		REQUIRE(registry.size() == 5);
+	}
+
+	SECTION("Removing fills the hole with the last item") {
+		REQUIRE(registry.Remove(items[1]));
+		REQUIRE(!registry.Remove(items[1]));
+		REQUIRE(!registry.Contains(items[1]));
+
+		REQUIRE(registry.size() == 4);
+		REQUIRE(registry.Get(1) == &items[4]);
+		REQUIRE(registry.GetIndex(items[4]) == 1);
+		REQUIRE(Sum(registry) == 29);
+
+		for (int i = 0; i < (int)registry.size(); i++) {
+			REQUIRE(registry.GetIndex(*registry.Get(i)) == i);
+		}
+	}
+
+	SECTION("Deferred removals leave holes until applied") {
+		registry.DeferRemovals();
+
+		REQUIRE(registry.Remove(items[4]));
+		REQUIRE(registry.Remove(items[0]));
+		REQUIRE(registry.Remove(items[2]));
+
+		REQUIRE(registry.size() == 5);
+		REQUIRE(registry.Get(0) == nullptr);
+		REQUIRE(registry.Get(1) == &items[1]);
+		REQUIRE(!registry.Contains(items[0]));
+
+		// Adding while deferring goes on the end as usual.
+		Registrable added;
+		added.m_Value = 32;
+		REQUIRE(registry.Add(added));
+		REQUIRE(registry.GetIndex(added) == 5);
+
+		registry.ApplyRemovals();
+
+		REQUIRE(registry.size() == 3);
+		REQUIRE(Sum(registry) == 2 + 8 + 32);
+
+		for (int i = 0; i < (int)registry.size(); i++) {
+			REQUIRE(registry.Get(i) != nullptr);
+			REQUIRE(registry.GetIndex(*registry.Get(i)) == i);
+		}
+	}
+
+	SECTION("Copies aren't registered") {
+		Registrable copy = items[3];
+		REQUIRE(!copy.GetRegistryIndex().IsRegistered());
+		REQUIRE(!registry.Contains(copy));
+	}
+}
+
+TEST_CASE("Benchmark: IndexedRegistry vs FindByAddress", "[.][Benchmark][Misc]")
+{
+	const int Count = 20000;
+
+	std::vector<Registrable> items(Count);
+
+	// Remove in a scrambled order, like a wave of enemies dying.
+	std::vector<int> order(Count);
+	for (int i = 0; i < Count; i++) order[i] = (int)(((long long)i * 7919) % Count);
+
+	using Clock = std::chrono::high_resolution_clock;
+	using std::chrono::duration_cast;
+	using std::chrono::microseconds;
+
+	const auto vectorStart = Clock::now();
+
+	{
+		std::vector<std::reference_wrapper<Registrable>> registry;
+
+		for (auto& item : items) {
+			if (FindByAddress(registry, item) == registry.end()) registry.push_back(item);
+		}
+
+		for (const int i : order) {
+			registry.erase(FindByAddress(registry, items[i]));
+		}
+
+		REQUIRE(registry.empty());
+	}
+
+	const auto registryStart = Clock::now();
+
+	{
+		IndexedRegistry<Registrable> registry;
+
+		for (auto& item : items) registry.Add(item);
+
+		for (const int i : order) registry.Remove(items[i]);
+
+		REQUIRE(registry.empty());
+	}
+
+	const auto end = Clock::now();
+
+	std::cout
+		<< Count << " registered and unregistered:\n"
+		<< "  FindByAddress:   " << duration_cast<microseconds>(registryStart - vectorStart).count() << "us\n"
+		<< "  IndexedRegistry: " << duration_cast<microseconds>(end - registryStart).count() << "us\n";
+}
@@ -7,6 +7,7 @@
 #include "Quiver/Entity/CustomComponent/CustomComponent.h"
 #include "Quiver/Entity/PhysicsComponent/PhysicsComponent.h"
 #include "Quiver/Entity/PhysicsComponent/PhysicsComponentDef.h"
+#include "Quiver/Physics/PhysicsUtils.h"
 #include "Quiver/World/World.h"
 
 using namespace qvr;
@@ -33,4 +34,39 @@ TEST_CASE("PhysicsComponent creation and cleanup", "[Physics]")
 	entity.reset();
 
 	REQUIRE(world.GetPhysicsWorld()->GetBodyCount() == 0);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Interpolate transforms", "[Physics]")
+{
+	const b2Transform from(b2Vec2(0.0f, 0.0f), b2Rot(0.0f));
+	const b2Transform to(b2Vec2(2.0f, -4.0f), b2Rot(1.0f));
+
+	SECTION("Ends")
+	{
+		REQUIRE(Physics::Interpolate(from, to, 0.0f).p.x == Approx(from.p.x));
+		REQUIRE(Physics::Interpolate(from, to, 0.0f).q.GetAngle() == Approx(from.q.GetAngle()));
+		REQUIRE(Physics::Interpolate(from, to, 1.0f).p.y == Approx(to.p.y));
+		REQUIRE(Physics::Interpolate(from, to, 1.0f).q.GetAngle() == Approx(to.q.GetAngle()));
+	}
+
+	SECTION("Middle")
+	{
+		const b2Transform middle = Physics::Interpolate(from, to, 0.5f);
+
+		REQUIRE(middle.p.x == Approx(1.0f));
+		REQUIRE(middle.p.y == Approx(-2.0f));
+		REQUIRE(middle.q.GetAngle() == Approx(0.5f));
+	}
+
+	SECTION("Rotation goes the short way round")
+	{
+		const b2Transform a(b2Vec2_zero, b2Rot(b2_pi - 0.1f));
+		const b2Transform b(b2Vec2_zero, b2Rot(-b2_pi + 0.1f));
+
+		const b2Rot middle = Physics::Interpolate(a, b, 0.5f).q;
+
+		// Half way between them is pi, not 0.
+		REQUIRE(middle.c == Approx(-1.0f));
+		REQUIRE(middle.s == Approx(0.0f).margin(0.0001f));
+	}
+}
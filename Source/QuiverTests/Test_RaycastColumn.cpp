@@ -0,0 +1,344 @@
+#include <catch.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <Box2D/Collision/Shapes/b2CircleShape.h>
+#include <Box2D/Dynamics/b2Body.h>
+#include <Box2D/Dynamics/b2Fixture.h>
+#include <Box2D/Dynamics/b2World.h>
+#include <Box2D/Dynamics/b2WorldCallbacks.h>
+
+#include "Quiver/Animation/AnimationData.h"
+#include "Quiver/Entity/Entity.h"
+#include "Quiver/Entity/CustomComponent/CustomComponent.h"
+#include "Quiver/Entity/PhysicsComponent/PhysicsComponentDef.h"
+#include "Quiver/Entity/RenderComponent/RenderComponent.h"
+#include "Quiver/Graphics/Camera3D.h"
+#include "Quiver/Graphics/FixtureRenderData.h"
+#include "Quiver/Graphics/RaycastColumn.h"
+#include "Quiver/Misc/ThreadPool.h"
+#include "Quiver/World/World.h"
+
+using namespace qvr;
+
+namespace {
+
+std::unique_ptr<Entity> MakeSprite(World& world, const b2Vec2& position, const Camera3D& camera)
+{
+	auto entity = std::make_unique<Entity>(
+		world,
+		PhysicsComponentDef(b2CircleShape(), position, 0.0f));
+
+	entity->AddGraphics({ { "Detached", true } });
+
+	RenderComponent& renderComponent = *entity->GetGraphics();
+
+	renderComponent.SetTextureRect(Animation::Rect{ 0, 0, 64, 64 });
+	renderComponent.UpdateDetachedBodyPosition();
+	renderComponent.UpdateDetachedBodyRotation(camera.GetRotation());
+
+	return entity;
+}
+
+const FixtureRenderData* FindRenderData(const World& world)
+{
+	for (const b2Body* body = world.GetPhysicsWorld()->GetBodyList(); body; body = body->GetNext()) {
+		for (const b2Fixture* fixture = body->GetFixtureList(); fixture; fixture = fixture->GetNext()) {
+			if (fixture->GetUserData()) {
+				return (const FixtureRenderData*)fixture->GetUserData();
+			}
+		}
+	}
+	return nullptr;
+}
+
+struct Hit {
+	const FixtureRenderData* m_RenderData;
+	b2Vec2 m_Point;
+	b2Vec2 m_Normal;
+	int m_ScreenX;
+};
+
+// Casts column i's ray the same way WorldRaycastRenderer does, adding every hit to hits.
+void CastColumn(
+	const World& world, 
+	const Camera3D& camera, 
+	const int width, 
+	const int i, 
+	std::vector<Hit>& hits)
+{
+	struct Callback : public b2RayCastCallback {
+		std::vector<Hit>& m_Hits;
+		int m_ScreenX = 0;
+
+		Callback(std::vector<Hit>& hits) : m_Hits(hits) {}
+
+		float32 ReportFixture(b2Fixture* fixture, const b2Vec2& point, const b2Vec2& normal, float32) override {
+			if (fixture->GetUserData()) {
+				m_Hits.push_back({ (const FixtureRenderData*)fixture->GetUserData(), point, normal, m_ScreenX });
+			}
+			return 1;
+		}
+	};
+
+	Callback callback(hits);
+	callback.m_ScreenX = i;
+
+	const b2Vec2 forwards = camera.GetForwards();
+	const b2Vec2 viewPlane =
+		camera.GetViewPlaneWidthModifier() * b2Vec2(-forwards.y, forwards.x);
+
+	b2Vec2 rayDir = forwards + ((-1.0f + (2.0f / width) * i) * viewPlane);
+	rayDir.Normalize();
+
+	world.GetPhysicsWorld()->RayCast(&callback, camera.GetPosition(), camera.GetPosition() + 50.0f * rayDir);
+}
+
+// Casts one ray per column, keeping every hit.
+std::vector<Hit> CastColumns(const World& world, const Camera3D& camera, const int width)
+{
+	std::vector<Hit> hits;
+
+	for (int i = 0; i < width; i++) {
+		CastColumn(world, camera, width, i, hits);
+	}
+
+	return hits;
+}
+
+// As above, but split across the pool like WorldRaycastRenderer's columns are: each
+// thread adds its columns' hits to its own arena, and they're gathered up in column order.
+std::vector<Hit> CastColumns(const World& world, const Camera3D& camera, const int width, ThreadPool& pool)
+{
+	struct ColumnHits {
+		unsigned m_Arena;
+		unsigned m_First;
+		unsigned m_Count;
+	};
+
+	std::vector<std::vector<Hit>> arenas(pool.GetThreadCount());
+	std::vector<ColumnHits> columns(width);
+
+	pool.ParallelForPerThread(width, [&](const int i, const unsigned threadIndex) {
+		std::vector<Hit>& arena = arenas[threadIndex];
+		const unsigned first = arena.size();
+
+		CastColumn(world, camera, width, i, arena);
+
+		columns[i] = ColumnHits{ threadIndex, first, (unsigned)arena.size() - first };
+	});
+
+	std::vector<Hit> hits;
+
+	for (const ColumnHits& column : columns) {
+		const auto first = arenas[column.m_Arena].begin() + column.m_First;
+		hits.insert(hits.end(), first, first + column.m_Count);
+	}
+
+	return hits;
+}
+
+}
+
+TEST_CASE("CalculateColumn projects a sprite in front of the camera", "[Graphics]")
+{
+	CustomComponentTypeLibrary types;
+	FixtureFilterBitNames filterBitNames;
+
+	WorldContext worldContext(types, filterBitNames);
+
+	World world(worldContext);
+
+	const Camera3D camera;
+	const sf::Vector2u targetSize(640, 480);
+	const float distance = 4.0f;
+
+	const auto entity = MakeSprite(world, distance * camera.GetForwards(), camera);
+
+	const FixtureRenderData* renderData = FindRenderData(world);
+
+	REQUIRE(renderData != nullptr);
+
+	const FixtureColumnInfo info = CalculateFixtureColumnInfo(*renderData, camera, targetSize);
+
+	// Straight through the middle of the sprite.
+	const RaycastColumn column = CalculateColumn(
+		info,
+		camera,
+		distance * camera.GetForwards(),
+		-camera.GetForwards(),
+		targetSize.x / 2);
+
+	REQUIRE(column.m_Distance == Approx(distance));
+	REQUIRE(column.m_X == Approx(targetSize.x / 2));
+
+	// A 1 metre tall sprite, 4 metres away, at eye level, fills a quarter of the screen height.
+	REQUIRE(column.m_Top == Approx(targetSize.y / 2 - targetSize.y / (2 * distance)));
+	REQUIRE(column.m_Bottom == Approx(targetSize.y / 2 + targetSize.y / (2 * distance)));
+
+	REQUIRE(column.m_U == Approx(32.0f));
+	REQUIRE(column.m_VTop == Approx(0.0f));
+	REQUIRE(column.m_VBottom == Approx(64.0f));
+}
+
+TEST_CASE("Casting columns across threads finds exactly what casting them serially does", "[Graphics]")
+{
+	CustomComponentTypeLibrary types;
+	FixtureFilterBitNames filterBitNames;
+
+	WorldContext worldContext(types, filterBitNames);
+
+	World world(worldContext);
+
+	const Camera3D camera;
+	const int width = 1920;
+
+	std::vector<std::unique_ptr<Entity>> sprites;
+
+	for (int y = 0; y < 20; y++) {
+		for (int x = -10; x < 10; x++) {
+			sprites.push_back(MakeSprite(world, b2Vec2(x * 0.8f, 2.0f + y * 1.1f), camera));
+		}
+	}
+
+	const std::vector<Hit> serialHits = CastColumns(world, camera, width);
+
+	REQUIRE(serialHits.size() > (unsigned)width);
+
+	for (const unsigned threadCount : { 2u, 4u, 0u }) {
+		ThreadPool pool(threadCount);
+
+		const std::vector<Hit> hits = CastColumns(world, camera, width, pool);
+
+		REQUIRE(hits.size() == serialHits.size());
+
+		for (unsigned i = 0; i < hits.size(); i++) {
+			REQUIRE(hits[i].m_RenderData == serialHits[i].m_RenderData);
+			REQUIRE(hits[i].m_ScreenX == serialHits[i].m_ScreenX);
+
+			// Down to the bit, not just approximately.
+			REQUIRE(std::memcmp(&hits[i].m_Point, &serialHits[i].m_Point, sizeof(b2Vec2)) == 0);
+			REQUIRE(std::memcmp(&hits[i].m_Normal, &serialHits[i].m_Normal, sizeof(b2Vec2)) == 0);
+		}
+	}
+}
+
+TEST_CASE("Benchmark: FixtureColumnInfo per hit vs per fixture", "[.][Benchmark][Graphics]")
+{
+	CustomComponentTypeLibrary types;
+	FixtureFilterBitNames filterBitNames;
+
+	WorldContext worldContext(types, filterBitNames);
+
+	World world(worldContext);
+
+	const Camera3D camera;
+	const sf::Vector2u targetSize(1920, 1080);
+
+	// Eight views, so that picking the view has to do some trigonometry.
+	const AnimationId animation = [&world]() {
+		nlohmann::json rects;
+		for (int i = 0; i < 8; i++) {
+			rects.push_back({ { "top", 0 },{ "left", i * 64 },{ "bottom", 64 },{ "right", (i + 1) * 64 } });
+		}
+
+		const auto data = AnimationData::FromJson({
+			{ "frameRects", rects },
+			{ "frameTimes", { 100 } },
+			{ "altViewsPerFrame", 7 } });
+
+		return world.GetAnimators().AddAnimation(data.value());
+	}();
+
+	std::vector<std::unique_ptr<Entity>> sprites;
+
+	for (int y = 0; y < 20; y++) {
+		for (int x = -10; x < 10; x++) {
+			sprites.push_back(MakeSprite(world, b2Vec2(x * 0.8f, 2.0f + y * 1.1f), camera));
+			sprites.back()->GetGraphics()->SetAnimation(animation);
+		}
+	}
+
+	const std::vector<Hit> hits = CastColumns(world, camera, targetSize.x);
+
+	// The renderer gets this for free from frustum culling.
+	std::unordered_map<const FixtureRenderData*, unsigned> fixtureIndices;
+	std::vector<const FixtureRenderData*> fixtures;
+	std::vector<unsigned> hitFixtureIndices;
+
+	for (const Hit& hit : hits) {
+		const auto inserted = fixtureIndices.insert({ hit.m_RenderData, fixtures.size() });
+		if (inserted.second) {
+			fixtures.push_back(hit.m_RenderData);
+		}
+		hitFixtureIndices.push_back(inserted.first->second);
+	}
+
+	const int Iterations = 100;
+
+	std::vector<RaycastColumn> perHitColumns;
+	std::vector<RaycastColumn> perFixtureColumns;
+	std::vector<FixtureColumnInfo> infos;
+
+	using Clock = std::chrono::high_resolution_clock;
+
+	const auto perHitStart = Clock::now();
+
+	for (int iteration = 0; iteration < Iterations; iteration++) {
+		perHitColumns.clear();
+
+		for (const Hit& hit : hits) {
+			perHitColumns.push_back(
+				CalculateColumn(
+					CalculateFixtureColumnInfo(*hit.m_RenderData, camera, targetSize),
+					camera,
+					hit.m_Point,
+					hit.m_Normal,
+					hit.m_ScreenX));
+		}
+	}
+
+	const auto perFixtureStart = Clock::now();
+
+	for (int iteration = 0; iteration < Iterations; iteration++) {
+		perFixtureColumns.clear();
+		infos.clear();
+
+		for (const FixtureRenderData* fixture : fixtures) {
+			infos.push_back(CalculateFixtureColumnInfo(*fixture, camera, targetSize));
+		}
+
+		for (unsigned i = 0; i < hits.size(); i++) {
+			perFixtureColumns.push_back(
+				CalculateColumn(
+					infos[hitFixtureIndices[i]],
+					camera,
+					hits[i].m_Point,
+					hits[i].m_Normal,
+					hits[i].m_ScreenX));
+		}
+	}
+
+	const auto end = Clock::now();
+
+	using std::chrono::duration_cast;
+	using std::chrono::microseconds;
+
+	std::cout
+		<< hits.size() << " hits on " << fixtures.size() << " sprites, "
+		<< Iterations << " iterations:\n"
+		<< "  per hit:     " << duration_cast<microseconds>(perFixtureStart - perHitStart).count() << "us\n"
+		<< "  per fixture: " << duration_cast<microseconds>(end - perFixtureStart).count() << "us\n";
+
+	REQUIRE(perHitColumns.size() == perFixtureColumns.size());
+
+	for (unsigned i = 0; i < perHitColumns.size(); i++) {
+		REQUIRE(perHitColumns[i].m_Top == perFixtureColumns[i].m_Top);
+		REQUIRE(perHitColumns[i].m_U == perFixtureColumns[i].m_U);
+	}
+}
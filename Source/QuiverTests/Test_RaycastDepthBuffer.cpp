@@ -0,0 +1,45 @@
+#include <catch.hpp>
+
+#include "Quiver/Graphics/RaycastDepthBuffer.h"
+
+using namespace qvr;
+
+TEST_CASE("RaycastDepthBuffer", "[Graphics]") {
+	RaycastDepthBuffer depthBuffer;
+	depthBuffer.Resize(4);
+
+	REQUIRE(depthBuffer.GetWidth() == 4);
+
+	SECTION("Empty columns hide nothing") {
+		for (int x = 0; x < 4; x++) {
+			REQUIRE(!depthBuffer.IsHidden(x, 1000.0f));
+		}
+	}
+
+	depthBuffer.SetColumn(1, 5.0f, 10.0f, 20.0f);
+
+	SECTION("Depth test") {
+		REQUIRE(depthBuffer.GetDepth(1) == 5.0f);
+		REQUIRE(!depthBuffer.IsHidden(1, 4.0f));
+		REQUIRE(depthBuffer.IsHidden(1, 6.0f));
+		REQUIRE(!depthBuffer.IsHidden(0, 6.0f));
+	}
+
+	SECTION("Span test") {
+		REQUIRE(depthBuffer.IsHidden(1, 10.0f, 6.0f));
+		REQUIRE(depthBuffer.IsHidden(1, 19.5f, 6.0f));
+		REQUIRE(!depthBuffer.IsHidden(1, 9.0f, 6.0f));
+		REQUIRE(!depthBuffer.IsHidden(1, 20.0f, 6.0f));
+		REQUIRE(!depthBuffer.IsHidden(1, 15.0f, 4.0f));
+	}
+
+	SECTION("Out of range columns hide nothing") {
+		REQUIRE(!depthBuffer.IsHidden(-1, 6.0f));
+		REQUIRE(!depthBuffer.IsHidden(4, 6.0f));
+	}
+
+	SECTION("Clear") {
+		depthBuffer.Clear();
+		REQUIRE(!depthBuffer.IsHidden(1, 6.0f));
+	}
+}
@@ -0,0 +1,181 @@
+#include <catch.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "Quiver/Misc/SlotMap.h"
+
+using namespace qvr;
+
+TEST_CASE("SlotMap", "[Misc]")
+{
+	SlotMap<int> map;
+
+	REQUIRE(map.empty());
+	REQUIRE(map.Get(0) == nullptr);
+
+	const SlotMapKey a = map.Insert(1);
+	const SlotMapKey b = map.Insert(2);
+	const SlotMapKey c = map.Insert(3);
+
+	REQUIRE(a != 0);
+	REQUIRE(map.size() == 3);
+
+	SECTION("Keys find their values") {
+		REQUIRE(*map.Get(a) == 1);
+		REQUIRE(*map.Get(b) == 2);
+		REQUIRE(*map.Get(c) == 3);
+	}
+
+	SECTION("Removing a value makes its key stale") {
+		REQUIRE(map.Remove(a));
+		REQUIRE(map.size() == 2);
+		REQUIRE(map.Get(a) == nullptr);
+		REQUIRE(!map.Contains(a));
+		REQUIRE(!map.Remove(a));
+	}
+
+	SECTION("Removing a value doesn't disturb the others") {
+		REQUIRE(map.Remove(a));
+		REQUIRE(*map.Get(b) == 2);
+		REQUIRE(*map.Get(c) == 3);
+
+		int sum = 0;
+		for (const int value : map) sum += value;
+		REQUIRE(sum == 5);
+
+		for (unsigned i = 0; i < map.size(); i++) {
+			REQUIRE(map.Get(map.GetKey(i)) == &*(map.begin() + i));
+		}
+	}
+
+	SECTION("Reusing a slot doesn't revive keys to it") {
+		REQUIRE(map.Remove(b));
+
+		const SlotMapKey d = map.Insert(4);
+
+		REQUIRE(GetSlotIndex(d) == GetSlotIndex(b));
+		REQUIRE(GetSlotGeneration(d) != GetSlotGeneration(b));
+		REQUIRE(map.Get(b) == nullptr);
+		REQUIRE(*map.Get(d) == 4);
+	}
+
+	SECTION("A free slot's next key doesn't find anything") {
+		REQUIRE(map.Remove(c));
+
+		const SlotMapKey next = ((SlotMapKey)(GetSlotGeneration(c) + 1) << 32) | GetSlotIndex(c);
+
+		REQUIRE(map.Get(next) == nullptr);
+	}
+
+	SECTION("Clear makes every key stale") {
+		map.Clear();
+
+		REQUIRE(map.empty());
+		REQUIRE(map.Get(a) == nullptr);
+		REQUIRE(map.Get(b) == nullptr);
+		REQUIRE(map.Get(c) == nullptr);
+
+		const SlotMapKey d = map.Insert(4);
+		REQUIRE(*map.Get(d) == 4);
+	}
+}
+
+namespace {
+
+// Roughly the size of an Entity.
+struct Payload {
+	int m_Value;
+	char m_Padding[124];
+};
+
+}
+
+TEST_CASE("Benchmark: SlotMap vs unordered_map entity storage", "[.][Benchmark][Misc]")
+{
+	const int Count = 100000;
+
+	using Clock = std::chrono::high_resolution_clock;
+	using std::chrono::duration_cast;
+	using std::chrono::microseconds;
+
+	// Lookups and removals happen in a scrambled order, like they would in a game.
+	std::vector<int> order(Count);
+	for (int i = 0; i < Count; i++) order[i] = (int)(((long long)i * 7919) % Count);
+
+	long long mapSum = 0;
+	long long slotMapSum = 0;
+
+	{
+		std::unordered_map<int, std::unique_ptr<Payload>> map;
+		std::vector<int> ids;
+
+		const auto createStart = Clock::now();
+
+		for (int i = 0; i < Count; i++) {
+			const int id = i + 1;
+			map[id] = std::make_unique<Payload>(Payload{ i });
+			ids.push_back(id);
+		}
+
+		const auto lookupStart = Clock::now();
+
+		for (const int i : order) mapSum += map.find(ids[i])->second->m_Value;
+
+		const auto iterateStart = Clock::now();
+
+		for (const auto& kv : map) mapSum += kv.second->m_Value;
+
+		const auto destroyStart = Clock::now();
+
+		for (const int i : order) map.erase(ids[i]);
+
+		const auto end = Clock::now();
+
+		std::cout
+			<< Count << " entities, unordered_map:\n"
+			<< "  create:  " << duration_cast<microseconds>(lookupStart - createStart).count() << "us\n"
+			<< "  lookup:  " << duration_cast<microseconds>(iterateStart - lookupStart).count() << "us\n"
+			<< "  iterate: " << duration_cast<microseconds>(destroyStart - iterateStart).count() << "us\n"
+			<< "  destroy: " << duration_cast<microseconds>(end - destroyStart).count() << "us\n";
+	}
+
+	{
+		SlotMap<std::unique_ptr<Payload>> map;
+		std::vector<SlotMapKey> ids;
+
+		const auto createStart = Clock::now();
+
+		for (int i = 0; i < Count; i++) {
+			ids.push_back(map.Insert(std::make_unique<Payload>(Payload{ i })));
+		}
+
+		const auto lookupStart = Clock::now();
+
+		for (const int i : order) slotMapSum += (*map.Get(ids[i]))->m_Value;
+
+		const auto iterateStart = Clock::now();
+
+		for (const auto& payload : map) slotMapSum += payload->m_Value;
+
+		const auto destroyStart = Clock::now();
+
+		for (const int i : order) map.Remove(ids[i]);
+
+		const auto end = Clock::now();
+
+		std::cout
+			<< Count << " entities, SlotMap:\n"
+			<< "  create:  " << duration_cast<microseconds>(lookupStart - createStart).count() << "us\n"
+			<< "  lookup:  " << duration_cast<microseconds>(iterateStart - lookupStart).count() << "us\n"
+			<< "  iterate: " << duration_cast<microseconds>(destroyStart - iterateStart).count() << "us\n"
+			<< "  destroy: " << duration_cast<microseconds>(end - destroyStart).count() << "us\n";
+
+		REQUIRE(map.empty());
+	}
+
+	REQUIRE(mapSum == slotMapSum);
+}
@@ -0,0 +1,236 @@
+#include <catch.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include "Quiver/Graphics/RaycastColumn.h"
+#include "Quiver/Graphics/SoftwareRasterizer.h"
+
+using namespace qvr;
+
+namespace {
+
+// No fog and no directional light, so columns come out the colour they go in.
+SoftwareLighting UnlitLighting()
+{
+	SoftwareLighting lighting;
+	lighting.m_Ambient.mColor = sf::Color::White;
+	lighting.m_Directional.SetColor(sf::Color::Black);
+	lighting.m_Fog.SetMaxIntensity(0.0f);
+	return lighting;
+}
+
+RaycastColumn MakeColumn(const float x, const float top, const float bottom)
+{
+	RaycastColumn column;
+	column.m_X = x;
+	column.m_Top = top;
+	column.m_Bottom = bottom;
+	column.m_Distance = 1.0f;
+	column.m_U = 0.0f;
+	column.m_VTop = 0.0f;
+	column.m_VBottom = 1.0f;
+	column.m_BlendColor = sf::Color::White;
+	column.m_Normal = sf::Vector2f(0.0f, -1.0f);
+	column.m_Texture = nullptr;
+	return column;
+}
+
+}
+
+TEST_CASE("SoftwareRasterizer", "[Graphics]")
+{
+	SoftwareRasterizer rasterizer;
+	rasterizer.SetSize(4, 8);
+
+	const SoftwareLighting lighting = UnlitLighting();
+
+	const sf::Color transparent(0, 0, 0, 0);
+
+	REQUIRE(rasterizer.GetPixel(2, 3) == transparent);
+
+	SECTION("Fills the pixels whose centres a column covers") {
+		rasterizer.Draw(MakeColumn(2.0f, 2.0f, 6.0f), SoftwareTexture(), lighting);
+
+		for (unsigned y = 0; y < 8; y++) {
+			const bool covered = y >= 2 && y < 6;
+			REQUIRE(rasterizer.GetPixel(2, y) == (covered ? sf::Color::White : transparent));
+			REQUIRE(rasterizer.GetPixel(1, y) == transparent);
+			REQUIRE(rasterizer.GetPixel(3, y) == transparent);
+		}
+	}
+
+	SECTION("Samples textures with nearest neighbour") {
+		// 2x2: red, green / blue, white
+		const sf::Uint8 pixels[] = {
+			255, 0, 0, 255,   0, 255, 0, 255,
+			0, 0, 255, 255,   255, 255, 255, 255 };
+
+		SoftwareTexture texture;
+		texture.m_Pixels = pixels;
+		texture.m_Width = 2;
+		texture.m_Height = 2;
+
+		RaycastColumn column = MakeColumn(0.0f, 0.0f, 8.0f);
+		column.m_U = 1.5f;
+		column.m_VBottom = 2.0f;
+
+		rasterizer.Draw(column, texture, lighting);
+
+		REQUIRE(rasterizer.GetPixel(0, 0) == sf::Color::Green);
+		REQUIRE(rasterizer.GetPixel(0, 3) == sf::Color::Green);
+		REQUIRE(rasterizer.GetPixel(0, 4) == sf::Color::White);
+		REQUIRE(rasterizer.GetPixel(0, 7) == sf::Color::White);
+	}
+
+	SECTION("Blends translucent columns over what is already there") {
+		rasterizer.Draw(MakeColumn(1.0f, 0.0f, 8.0f), SoftwareTexture(), lighting);
+
+		RaycastColumn translucent = MakeColumn(1.0f, 0.0f, 8.0f);
+		translucent.m_BlendColor = sf::Color(0, 0, 0, 51);
+
+		rasterizer.Draw(translucent, SoftwareTexture(), lighting);
+
+		// 80% white showing through 20% black.
+		REQUIRE(rasterizer.GetPixel(1, 4) == sf::Color(204, 204, 204, 255));
+	}
+
+	SECTION("Applies fog by distance") {
+		SoftwareLighting foggy = lighting;
+		foggy.m_Fog.SetColor(sf::Color::Red);
+		foggy.m_Fog.SetMaxIntensity(1.0f);
+		foggy.m_Fog.SetMinDistance(0.0f);
+		foggy.m_Fog.SetMaxDistance(10.0f);
+
+		RaycastColumn column = MakeColumn(3.0f, 0.0f, 8.0f);
+		column.m_BlendColor = sf::Color::Black;
+		column.m_Distance = 5.0f;
+
+		rasterizer.Draw(column, SoftwareTexture(), foggy);
+
+		REQUIRE(rasterizer.GetPixel(3, 0) == sf::Color(128, 0, 0, 255));
+	}
+
+	SECTION("Rows are copied out top to bottom") {
+		rasterizer.Draw(MakeColumn(1.0f, 0.0f, 1.0f), SoftwareTexture(), lighting);
+
+		std::vector<sf::Uint8> pixels;
+		rasterizer.CopyPixels(pixels);
+
+		REQUIRE(pixels.size() == 4 * 8 * 4);
+		REQUIRE(pixels[4 + 3] == 255);
+		REQUIRE(pixels[(4 * 4) + 4 + 3] == 0);
+	}
+}
+
+TEST_CASE("SoftwareRasterizer SIMD and scalar paths agree", "[Graphics]")
+{
+	if (!SoftwareRasterizer::IsSimdAvailable()) return;
+
+	SoftwareRasterizer simd;
+	SoftwareRasterizer scalar;
+	simd.SetSize(64, 64);
+	scalar.SetSize(64, 64);
+	scalar.SetUseSimd(false);
+
+	SoftwareLighting lighting;
+	lighting.m_Ambient.mColor = sf::Color(200, 180, 160, 255);
+	lighting.m_Fog.SetColor(sf::Color(10, 20, 30));
+	lighting.m_Directional.SetColor(sf::Color(40, 40, 40));
+
+	std::vector<sf::Uint8> texturePixels(16 * 16 * 4);
+
+	std::mt19937 random(1234);
+
+	for (auto& channel : texturePixels) {
+		channel = (sf::Uint8)(random() % 256);
+	}
+
+	SoftwareTexture texture;
+	texture.m_Pixels = texturePixels.data();
+	texture.m_Width = 16;
+	texture.m_Height = 16;
+
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	for (int i = 0; i < 500; i++) {
+		RaycastColumn column = MakeColumn(
+			(float)(random() % 64),
+			unit(random) * 40.0f - 8.0f,
+			unit(random) * 40.0f + 32.0f);
+		column.m_U = unit(random) * 16.0f;
+		column.m_VBottom = 16.0f;
+		column.m_Distance = unit(random) * 30.0f;
+		column.m_Normal = sf::Vector2f(unit(random) * 2 - 1, unit(random) * 2 - 1);
+		column.m_BlendColor = sf::Color(
+			(sf::Uint8)(random() % 256),
+			(sf::Uint8)(random() % 256),
+			(sf::Uint8)(random() % 256),
+			(sf::Uint8)(random() % 256));
+
+		simd.Draw(column, texture, lighting);
+		scalar.Draw(column, texture, lighting);
+	}
+
+	for (unsigned x = 0; x < 64; x++) {
+		for (unsigned y = 0; y < 64; y++) {
+			REQUIRE(simd.GetPixel(x, y) == scalar.GetPixel(x, y));
+		}
+	}
+}
+
+TEST_CASE("Benchmark: SoftwareRasterizer", "[.][Benchmark][Graphics]")
+{
+	const unsigned Width = 1920;
+	const unsigned Height = 1080;
+	const int Layers = 4;
+	const int Frames = 10;
+
+	std::vector<sf::Uint8> texturePixels(64 * 64 * 4, 200);
+
+	SoftwareTexture texture;
+	texture.m_Pixels = texturePixels.data();
+	texture.m_Width = 64;
+	texture.m_Height = 64;
+
+	SoftwareLighting lighting;
+
+	std::vector<RaycastColumn> columns;
+
+	for (int layer = 0; layer < Layers; layer++) {
+		for (unsigned x = 0; x < Width; x++) {
+			RaycastColumn column = MakeColumn((float)x, 100.0f + layer * 50.0f, Height - 100.0f - layer * 50.0f);
+			column.m_U = (float)(x % 64);
+			column.m_VBottom = 64.0f;
+			column.m_Distance = 20.0f - layer * 4.0f;
+			column.m_BlendColor = sf::Color(255, 255, 255, layer == 0 ? 255 : 192);
+			columns.push_back(column);
+		}
+	}
+
+	for (const bool useSimd : { false, true }) {
+		if (useSimd && !SoftwareRasterizer::IsSimdAvailable()) continue;
+
+		SoftwareRasterizer rasterizer;
+		rasterizer.SetSize(Width, Height);
+		rasterizer.SetUseSimd(useSimd);
+
+		const auto start = std::chrono::high_resolution_clock::now();
+
+		for (int frame = 0; frame < Frames; frame++) {
+			rasterizer.Clear();
+
+			for (const RaycastColumn& column : columns) {
+				rasterizer.Draw(column, texture, lighting);
+			}
+		}
+
+		const auto end = std::chrono::high_resolution_clock::now();
+
+		std::cout
+			<< (useSimd ? "SIMD:   " : "Scalar: ")
+			<< std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / Frames
+			<< "us per " << Width << "x" << Height << " frame, " << columns.size() << " columns\n";
+	}
+}
@@ -0,0 +1,77 @@
+#include <catch.hpp>
+
+#include <vector>
+
+#include "Quiver/Graphics/TextureAtlas.h"
+
+using namespace qvr;
+
+namespace {
+
+struct PackedRect {
+	sf::Vector2u position;
+	sf::Vector2u size;
+};
+
+bool Overlap(const PackedRect& a, const PackedRect& b, const unsigned padding) {
+	return
+		a.position.x < b.position.x + b.size.x + padding * 2 &&
+		b.position.x < a.position.x + a.size.x + padding * 2 &&
+		a.position.y < b.position.y + b.size.y + padding * 2 &&
+		b.position.y < a.position.y + a.size.y + padding * 2;
+}
+
+}
+
+TEST_CASE("ShelfPacker", "[Graphics]") {
+	const unsigned padding = 1;
+
+	ShelfPacker packer(sf::Vector2u(64, 64), padding);
+
+	SECTION("Rejects rectangles that can't fit") {
+		sf::Vector2u position;
+		REQUIRE(!packer.Pack(sf::Vector2u(63, 4), position));
+		REQUIRE(!packer.Pack(sf::Vector2u(4, 63), position));
+		REQUIRE(packer.Pack(sf::Vector2u(62, 62), position));
+		REQUIRE(position == sf::Vector2u(padding, padding));
+		REQUIRE(!packer.Pack(sf::Vector2u(1, 1), position));
+	}
+
+	SECTION("Packed rectangles stay in bounds and don't overlap") {
+		std::vector<PackedRect> packed;
+
+		const sf::Vector2u sizes[] = {
+			{ 16, 16 }, { 8, 8 }, { 16, 8 }, { 4, 12 }, { 10, 10 }, { 30, 6 }, { 6, 30 }
+		};
+
+		for (int i = 0; ; i++) {
+			PackedRect rect;
+			rect.size = sizes[i % (sizeof(sizes) / sizeof(sizes[0]))];
+
+			if (!packer.Pack(rect.size, rect.position)) break;
+
+			REQUIRE(rect.position.x >= padding);
+			REQUIRE(rect.position.y >= padding);
+			REQUIRE(rect.position.x + rect.size.x + padding <= 64);
+			REQUIRE(rect.position.y + rect.size.y + padding <= 64);
+
+			for (const PackedRect& other : packed) {
+				REQUIRE(!Overlap(rect, other, padding));
+			}
+
+			packed.push_back(rect);
+		}
+
+		REQUIRE(packed.size() > 10);
+	}
+
+	SECTION("Short rectangles go on short shelves") {
+		sf::Vector2u tall, shortA, shortB;
+		REQUIRE(packer.Pack(sf::Vector2u(40, 30), tall));
+		REQUIRE(packer.Pack(sf::Vector2u(40, 8), shortA));
+		// Fits next to the tall one, but there's a shelf that fits it better.
+		REQUIRE(packer.Pack(sf::Vector2u(8, 8), shortB));
+
+		REQUIRE(shortB.y == shortA.y);
+	}
+}
@@ -0,0 +1,116 @@
+#include <catch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "Quiver/Misc/ThreadPool.h"
+
+using namespace qvr;
+
+namespace {
+
+// Sections can't go inside a loop, since Catch only enters them on its first pass.
+// Instead, each thread count gets a section of its own that runs all of these.
+void TestThreadPool(const unsigned threadCount)
+{
+	ThreadPool pool(threadCount);
+
+	REQUIRE(pool.GetThreadCount() == ThreadPool::ResolveThreadCount(threadCount));
+
+	SECTION("ParallelFor visits every index exactly once") {
+		for (const int count : { 0, 1, 7, 1920 })
+		{
+			std::vector<std::atomic<int>> visits(count);
+
+			for (auto& v : visits) v = 0;
+
+			pool.ParallelFor(count, [&visits](const int i) { visits[i]++; });
+
+			for (const auto& v : visits) {
+				REQUIRE(v == 1);
+			}
+		}
+	}
+
+	SECTION("ParallelForPerThread passes a valid thread index") {
+		std::vector<int> counts(pool.GetThreadCount(), 0);
+
+		std::atomic<bool> validIndices(true);
+
+		// Each thread only touches its own slot, so no atomics needed.
+		// Catch isn't thread-safe, so it's all checked once the job is done.
+		pool.ParallelForPerThread(1000, [&](const int, const unsigned threadIndex) {
+			if (threadIndex < counts.size()) {
+				counts[threadIndex]++;
+			}
+			else {
+				validIndices = false;
+			}
+		});
+
+		REQUIRE(validIndices);
+
+		int total = 0;
+		for (const int c : counts) total += c;
+
+		REQUIRE(total == 1000);
+	}
+
+	SECTION("Thread count can be changed between jobs") {
+		pool.SetThreadCount(3);
+
+		REQUIRE(pool.GetThreadCount() == 3);
+
+		std::atomic<int> total(0);
+
+		pool.ParallelFor(100, [&total](const int i) { total += i; });
+
+		REQUIRE(total == 4950);
+	}
+
+	SECTION("Threads that run out of work take it from the others") {
+		const int count = 200;
+		const int firstShare = count / (int)pool.GetThreadCount();
+
+		std::vector<std::atomic<int>> visits(count);
+		std::vector<unsigned> threadIndices(count);
+
+		for (auto& v : visits) v = 0;
+
+		// The calling thread's share is much slower than everybody else's.
+		pool.ParallelForPerThread(count, [&](const int i, const unsigned threadIndex) {
+			if (i < firstShare) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+			visits[i]++;
+			threadIndices[i] = threadIndex;
+		});
+
+		for (const auto& v : visits) {
+			REQUIRE(v == 1);
+		}
+
+		if (pool.GetThreadCount() > 1) {
+			const bool stolen =
+				std::any_of(
+					threadIndices.begin(),
+					threadIndices.begin() + firstShare,
+					[](const unsigned threadIndex) { return threadIndex != 0; });
+
+			REQUIRE(stolen);
+		}
+	}
+}
+
+}
+
+TEST_CASE("ThreadPool", "[Misc]")
+{
+	SECTION("1 thread") { TestThreadPool(1); }
+	SECTION("2 threads") { TestThreadPool(2); }
+	SECTION("4 threads") { TestThreadPool(4); }
+	SECTION("One per hardware thread") { TestThreadPool(0); }
+}
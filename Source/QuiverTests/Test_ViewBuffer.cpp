@@ -25,17 +25,45 @@ TEST_CASE("ViewBuffer", "[Graphics]") {
 
 	REQUIRE(vb.viewCount == 0);
 
-	SECTION("SetViews clamps input") {
-		const auto views = GenerateRects<vb.views.size() + 1>();
+	SECTION("SetViews points at the views rather than copying them") {
+		const auto views = GenerateRects<9>();
 
 		SetViews(vb, views);
 
-		REQUIRE(vb.viewCount == (int)vb.views.size());
-		REQUIRE(GetViews(vb) == gsl::make_span(&views[0], vb.viewCount));
-		REQUIRE(GetViews(vb) != gsl::make_span(views));
+		REQUIRE(vb.viewCount == (int)views.size());
+		REQUIRE(GetViews(vb).data() == views.data());
+		REQUIRE(GetView(vb) == views[0]);
 	}
 
-	SetViews(vb, GenerateRects<4>());  
+	SECTION("SetView keeps a single view") {
+		const Rect view{ 1, 2, 3, 4 };
+
+		const auto animated = GenerateRects<4>();
+
+		SetViews(vb, animated);
+		SetView(vb, view);
+
+		REQUIRE(vb.viewCount == 1);
+		REQUIRE(GetViews(vb) == gsl::make_span(&view, 1));
+		REQUIRE(GetView(vb) == view);
+	}
+
+	SECTION("KeepFirstView copies the first view it points at") {
+		auto animated = GenerateRects<3>();
+
+		SetViews(vb, animated);
+		KeepFirstView(vb);
+
+		animated.fill(Rect{});
+
+		REQUIRE(vb.viewCount == 1);
+		REQUIRE(vb.views == nullptr);
+		REQUIRE(GetView(vb) == GenerateRects<3>()[0]);
+	}
+
+	const auto views = GenerateRects<4>();
+
+	SetViews(vb, views);
 
 	// Rotate the object and assert that we see the right frame from each angle.
 	{
@@ -51,7 +79,7 @@ TEST_CASE("ViewBuffer", "[Graphics]") {
 
 			const Rect r = CalculateView(vb, objectAngle, viewAngle);
 			
-			REQUIRE(r == vb.views[i]);
+			REQUIRE(r == views[i]);
 		}
 	}
 }